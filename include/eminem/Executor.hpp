@@ -0,0 +1,136 @@
+#ifndef EMINEM_EXECUTOR_HPP
+#define EMINEM_EXECUTOR_HPP
+
+#include <vector>
+#include <deque>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <stdexcept>
+
+#include "sanisizer/sanisizer.hpp"
+
+/**
+ * @file Executor.hpp
+ * @brief Execute parsing jobs on a persistent set of threads.
+ */
+
+namespace eminem {
+
+/**
+ * @brief Interface for executing parsing jobs.
+ *
+ * This allows applications to supply their own thread pool to the `Parser` via `ParserOptions::executor`.
+ * A single `Executor` may be shared across many `Parser` instances, including those that are parsing concurrently in different threads.
+ * Each parallelized `Parser::scan_integer()` (or related method) will submit one job per chunk of the file,
+ * with at most `ParserOptions::num_threads` jobs from the same scan being submitted at any given time.
+ */
+class Executor {
+public:
+    /**
+     * @cond
+     */
+    Executor() = default;
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+    virtual ~Executor() = default;
+    /**
+     * @endcond
+     */
+
+    /**
+     * Submit a job for execution.
+     * This may be executed on any thread, including the calling thread.
+     * However, it should not be possible for `job` to block indefinitely on the completion of other submitted jobs.
+     *
+     * @param job Job to be executed.
+     * This will not throw any exceptions.
+     */
+    virtual void submit(std::function<void()> job) = 0;
+};
+
+/**
+ * @brief Persistent thread pool for parsing.
+ *
+ * This creates a fixed number of threads upon construction, which are re-used for all jobs until the pool is destroyed.
+ * Jobs are executed in the order in which they were submitted, so concurrent scans sharing the same pool will be scheduled fairly;
+ * each scan can only have a limited number of jobs in the queue, after which it must wait for its earlier jobs to complete before submitting new ones.
+ * This avoids the cost of creating and joining threads for each call to `Parser::scan_integer()` (or related methods),
+ * which is most noticeable when parsing many small files.
+ *
+ * Note that jobs should never be submitted from within a job running on the same pool, as this may result in a deadlock.
+ * In particular, scans should not be performed within a job that is executing on the pool that was passed to the `Parser`.
+ */
+class PersistentThreadPool final : public Executor {
+public:
+    /**
+     * @param num_threads Number of threads to create in the pool.
+     */
+    PersistentThreadPool(int num_threads) {
+        if (num_threads < 1) {
+            throw std::runtime_error("number of threads in the pool should be positive");
+        }
+        my_threads.reserve(sanisizer::as_size_type<std::vector<std::thread> >(num_threads));
+        for (int t = 0; t < num_threads; ++t) {
+            my_threads.emplace_back([this]() -> void {
+                while (1) {
+                    std::unique_lock lck(my_mut);
+                    my_cv.wait(lck, [&]() -> bool { return my_terminated || !my_jobs.empty(); });
+                    if (my_jobs.empty()) { // only possible if terminated.
+                        return;
+                    }
+
+                    auto job = std::move(my_jobs.front());
+                    my_jobs.pop_front();
+                    lck.unlock(); // release the lock so that other threads can fetch jobs while this one is running.
+                    job();
+                }
+            });
+        }
+    }
+
+    /**
+     * @cond
+     */
+    ~PersistentThreadPool() {
+        {
+            std::lock_guard lck(my_mut);
+            my_terminated = true;
+        }
+        my_cv.notify_all();
+        for (auto& thread : my_threads) {
+            thread.join();
+        }
+    }
+    /**
+     * @endcond
+     */
+
+private:
+    std::vector<std::thread> my_threads;
+    std::mutex my_mut;
+    std::condition_variable my_cv;
+    std::deque<std::function<void()> > my_jobs;
+    bool my_terminated = false;
+
+public:
+    /**
+     * @return Number of threads in the pool.
+     */
+    int num_threads() const {
+        return my_threads.size();
+    }
+
+    void submit(std::function<void()> job) {
+        {
+            std::lock_guard lck(my_mut);
+            my_jobs.push_back(std::move(job));
+        }
+        my_cv.notify_one(); // only notify once the lock is released for optimal performance.
+    }
+};
+
+}
+
+#endif
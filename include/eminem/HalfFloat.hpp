@@ -0,0 +1,197 @@
+#ifndef EMINEM_HALF_FLOAT_HPP
+#define EMINEM_HALF_FLOAT_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+#include <type_traits>
+
+/**
+ * @file HalfFloat.hpp
+ * @brief 16-bit floating-point types for compact storage of real values.
+ */
+
+namespace eminem {
+
+/**
+ * @cond
+ */
+inline std::uint32_t float_to_bits(float x) {
+    std::uint32_t bits;
+    std::memcpy(&bits, &x, sizeof(bits));
+    return bits;
+}
+
+inline float bits_to_float(std::uint32_t bits) {
+    float x;
+    std::memcpy(&x, &bits, sizeof(x));
+    return x;
+}
+
+// Narrows a double to a float with round-to-odd, i.e., truncating and then setting the last bit if the result is inexact.
+// A float has more than twice the precision of either 16-bit type, so rounding this float to nearest gives the same result as rounding 'x' directly.
+inline float round_to_odd_float(double x) {
+    if (std::isnan(x)) {
+        return static_cast<float>(x);
+    }
+    const double ax = std::fabs(x);
+    std::uint32_t bits = float_to_bits(static_cast<float>(ax));
+    const double rounded = bits_to_float(bits);
+    if (rounded != ax) {
+        if (rounded > ax) {
+            --bits; // moving towards zero, which also turns an overflowing infinity into the largest finite float.
+        }
+        bits |= 1u;
+    }
+    if (std::signbit(x)) {
+        bits |= 0x80000000u;
+    }
+    return bits_to_float(bits);
+}
+/**
+ * @endcond
+ */
+
+/**
+ * @brief IEEE 754 half-precision floating-point number.
+ *
+ * This is a storage-only type, i.e., it does not support any arithmetic.
+ * It can be used as `Type_` in `Parser::scan_real()` to halve the memory usage of the parsed values relative to `float`.
+ * Each value is parsed as a `double` and rounded once to the nearest half-precision value (ties to even), so the result is correctly rounded from the decimal input.
+ * Values beyond the representable range are converted to infinities, and NaNs are preserved.
+ */
+struct Float16 {
+    /**
+     * Default constructor, creating a positive zero.
+     */
+    Float16() = default;
+
+    /**
+     * @param x Value to be stored, rounded to the nearest representable value.
+     */
+    explicit Float16(float x) {
+        // Based on Fabian Giesen's float_to_half_fast3_rtne().
+        std::uint32_t f = float_to_bits(x);
+        const std::uint32_t sign = f & 0x80000000u;
+        f ^= sign;
+
+        std::uint32_t out;
+        if (f >= (127u + 16u) << 23) { // too large for a half, or Inf/NaN.
+            out = (f > 0x7F800000u ? 0x7E00u : 0x7C00u);
+        } else if (f < 113u << 23) { // subnormal or zero, where the floating-point addition performs the rounding for us.
+            const float denorm_magic = bits_to_float(((127u - 15u) + (23u - 10u) + 1u) << 23);
+            out = float_to_bits(bits_to_float(f) + denorm_magic) - float_to_bits(denorm_magic);
+        } else {
+            const std::uint32_t mant_odd = (f >> 13) & 1u;
+            f += ((15u - 127u) << 23) + 0xFFFu + mant_odd; // rebiasing the exponent and rounding to nearest even; overflows become Inf.
+            out = f >> 13;
+        }
+
+        bits = static_cast<std::uint16_t>(out | (sign >> 16));
+    }
+
+    /**
+     * @param x Value to be stored, rounded to the nearest representable value.
+     * This is rounded directly from `x`, i.e., without any intermediate rounding to `float`.
+     */
+    explicit Float16(double x) : Float16(round_to_odd_float(x)) {}
+
+    /**
+     * Bit representation of the half-precision value.
+     */
+    std::uint16_t bits = 0;
+
+    /**
+     * @return The stored value as a `float`, which is always exact.
+     */
+    float to_float() const {
+        // Based on Fabian Giesen's half_to_float().
+        constexpr std::uint32_t shifted_exp = 0x7C00u << 13;
+        std::uint32_t out = (static_cast<std::uint32_t>(bits) & 0x7FFFu) << 13;
+        const std::uint32_t exp = shifted_exp & out;
+        out += (127u - 15u) << 23;
+        if (exp == shifted_exp) { // Inf/NaN.
+            out += (128u - 16u) << 23;
+        } else if (exp == 0) { // zero or subnormal.
+            out += 1u << 23;
+            out = float_to_bits(bits_to_float(out) - bits_to_float(113u << 23));
+        }
+        out |= (static_cast<std::uint32_t>(bits) & 0x8000u) << 16;
+        return bits_to_float(out);
+    }
+
+    /**
+     * @return The stored value as a `float`.
+     */
+    explicit operator float() const {
+        return to_float();
+    }
+};
+
+/**
+ * @brief Brain floating-point number.
+ *
+ * This is a storage-only type with the same exponent range as `float` but only 8 bits of precision.
+ * It can be used as `Type_` in `Parser::scan_real()` to halve the memory usage of the parsed values relative to `float`.
+ * Each value is parsed as a `double` and rounded once to the nearest bfloat16 value (ties to even), so the result is correctly rounded from the decimal input.
+ * NaNs are preserved.
+ */
+struct BFloat16 {
+    /**
+     * Default constructor, creating a positive zero.
+     */
+    BFloat16() = default;
+
+    /**
+     * @param x Value to be stored, rounded to the nearest representable value.
+     */
+    explicit BFloat16(float x) {
+        std::uint32_t f = float_to_bits(x);
+        if ((f & 0x7FFFFFFFu) > 0x7F800000u) {
+            bits = static_cast<std::uint16_t>((f >> 16) | 0x40u); // forcing a quiet NaN so that truncation doesn't turn it into an infinity.
+        } else {
+            f += 0x7FFFu + ((f >> 16) & 1u);
+            bits = static_cast<std::uint16_t>(f >> 16);
+        }
+    }
+
+    /**
+     * @param x Value to be stored, rounded to the nearest representable value.
+     * This is rounded directly from `x`, i.e., without any intermediate rounding to `float`.
+     */
+    explicit BFloat16(double x) : BFloat16(round_to_odd_float(x)) {}
+
+    /**
+     * Bit representation of the bfloat16 value.
+     */
+    std::uint16_t bits = 0;
+
+    /**
+     * @return The stored value as a `float`, which is always exact.
+     */
+    float to_float() const {
+        return bits_to_float(static_cast<std::uint32_t>(bits) << 16);
+    }
+
+    /**
+     * @return The stored value as a `float`.
+     */
+    explicit operator float() const {
+        return to_float();
+    }
+};
+
+/**
+ * @cond
+ */
+template<typename Type_>
+struct is_half_float {
+    static constexpr bool value = std::is_same<Type_, Float16>::value || std::is_same<Type_, BFloat16>::value;
+};
+/**
+ * @endcond
+ */
+
+}
+
+#endif
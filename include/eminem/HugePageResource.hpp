@@ -0,0 +1,127 @@
+#ifndef EMINEM_HUGE_PAGE_RESOURCE_HPP
+#define EMINEM_HUGE_PAGE_RESOURCE_HPP
+
+#include <memory_resource>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <cassert>
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+/**
+ * @file HugePageResource.hpp
+ * @brief Memory resource backed by huge pages.
+ */
+
+namespace eminem {
+
+/**
+ * @brief Memory resource backed by huge pages.
+ *
+ * On Linux, large allocations are directly mapped from the operating system with a request for huge pages.
+ * We first attempt to use explicitly reserved huge pages (i.e., `MAP_HUGETLB`);
+ * if none are available, we fall back to a regular mapping that is advised to use transparent huge pages (i.e., `MADV_HUGEPAGE`).
+ * This reduces the number of page faults and TLB misses when filling large buffers in `Parser`.
+ * Small allocations and allocations on other platforms are passed to the upstream resource.
+ * Explicit huge pages are always requested with a size of 2 MiB, regardless of the system's default huge page size;
+ * if the system does not support this size, the fallback to transparent huge pages is used instead.
+ *
+ * This is most effective as the upstream resource for a pooling resource (e.g., `std::pmr::synchronized_pool_resource`),
+ * which can then be passed to `ParserOptions::memory_resource`.
+ * The pool will request large blocks from the `HugePageResource`, and re-use these blocks across scans and `Parser` instances.
+ */
+class HugePageResource final : public std::pmr::memory_resource {
+public:
+    /**
+     * @param min_size Minimum size of an allocation to use huge pages, in bytes.
+     * Smaller allocations are passed to `upstream`, as are all zero-byte allocations (even if `min_size = 0`).
+     * @param upstream Upstream memory resource for small allocations.
+     */
+    HugePageResource(std::size_t min_size = 2097152, std::pmr::memory_resource* upstream = std::pmr::get_default_resource()) :
+        my_min_size(min_size),
+        my_upstream(upstream)
+    {}
+
+private:
+    std::size_t my_min_size;
+    std::pmr::memory_resource* my_upstream;
+
+#if defined(__linux__)
+    static constexpr std::size_t huge_page_size = 2097152;
+
+    static std::size_t round_up(std::size_t bytes) {
+        return ((bytes + huge_page_size - 1) / huge_page_size) * huge_page_size;
+    }
+
+    bool use_huge_pages(std::size_t bytes, std::size_t alignment) const {
+        return bytes > 0 && bytes >= my_min_size && alignment <= huge_page_size;
+    }
+
+    static void unmap(void* ptr, std::size_t bytes) {
+        [[maybe_unused]] const int status = munmap(ptr, bytes);
+        assert(status == 0);
+    }
+#endif
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) {
+#if defined(__linux__)
+        if (use_huge_pages(bytes, alignment)) {
+            const auto full = round_up(bytes);
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+            // Explicitly requesting 2 MiB pages, otherwise the kernel would use the system's default huge page size (e.g., 1 GiB)
+            // and round up the mapping to a multiple of that size, such that the munmap() in do_deallocate() would fail.
+            void* ptr = mmap(NULL, full, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | (21 << MAP_HUGE_SHIFT), -1, 0); // 2^21 = 2 MiB.
+            if (ptr != MAP_FAILED) {
+                return ptr;
+            }
+#endif
+
+            // Regular mappings are only aligned to the base page size, so we over-allocate by one huge page and trim the excess on either side.
+            // This guarantees any alignment up to the huge page size and allows the entire region to be backed by transparent huge pages.
+            // The remaining mapping is exactly 'full' bytes, so it can be released in do_deallocate() without remembering the original mapping.
+            void* raw = mmap(NULL, full + huge_page_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (raw == MAP_FAILED) {
+                throw std::bad_alloc();
+            }
+            const auto start = reinterpret_cast<std::uintptr_t>(raw);
+            const auto aligned = ((start + huge_page_size - 1) / huge_page_size) * huge_page_size;
+            const std::size_t leading = aligned - start;
+            if (leading) {
+                unmap(raw, leading);
+            }
+            const std::size_t trailing = huge_page_size - leading;
+            if (trailing) {
+                unmap(reinterpret_cast<void*>(aligned + full), trailing);
+            }
+
+            void* fallback = reinterpret_cast<void*>(aligned);
+#ifdef MADV_HUGEPAGE
+            madvise(fallback, full, MADV_HUGEPAGE); // this is only advisory, so we don't care if it fails.
+#endif
+            return fallback;
+        }
+#endif
+        return my_upstream->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) {
+#if defined(__linux__)
+        if (use_huge_pages(bytes, alignment)) {
+            unmap(ptr, round_up(bytes));
+            return;
+        }
+#endif
+        my_upstream->deallocate(ptr, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+        return this == &other;
+    }
+};
+
+}
+
+#endif
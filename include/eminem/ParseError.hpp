@@ -0,0 +1,81 @@
+#ifndef EMINEM_PARSE_ERROR_HPP
+#define EMINEM_PARSE_ERROR_HPP
+
+#include <string>
+#include <stdexcept>
+
+/**
+ * @file ParseError.hpp
+ * @brief Errors from parsing the data lines.
+ */
+
+namespace eminem {
+
+/**
+ * Type of error in a data line of a Matrix Market file.
+ */
+enum class ParseErrorCode : unsigned char {
+    MISSING_FIELD, /**< Fewer fields than expected, e.g., a premature newline or end of file. */
+    EXTRA_FIELD, /**< More fields than expected. */
+    EMPTY_FIELD, /**< A field with no characters other than whitespace. */
+    INVALID_VALUE, /**< A field that could not be interpreted as a value of the expected type. */
+    VALUE_OVERFLOW, /**< An integer that cannot be represented by the requested type. */
+    INDEX_NOT_POSITIVE, /**< A row or column index of zero. */
+    INDEX_OUT_OF_RANGE /**< A row or column index that is greater than the number of rows or columns. */
+};
+
+/**
+ * @brief Error in a data line of a Matrix Market file.
+ *
+ * This is thrown by `Parser::scan_integer()` and related methods when a data line cannot be parsed.
+ * In addition to the usual message, it reports the type of error and its location in the file,
+ * allowing callers to handle errors programmatically without inspecting the message.
+ */
+class ParseError final : public std::runtime_error {
+public:
+    /**
+     * @param code Type of error.
+     * @param message Message describing the error, including its location.
+     * @param is_line Whether `position` is a line number.
+     * @param position 1-based line number of the error if `is_line = true`, otherwise the 0-based byte offset of the error from the start of the file.
+     */
+    ParseError(ParseErrorCode code, const std::string& message, bool is_line, unsigned long long position) :
+        std::runtime_error(message),
+        my_code(code),
+        my_is_line(is_line),
+        my_position(position)
+    {}
+
+private:
+    ParseErrorCode my_code;
+    bool my_is_line;
+    unsigned long long my_position;
+
+public:
+    /**
+     * @return Type of error.
+     */
+    ParseErrorCode code() const {
+        return my_code;
+    }
+
+    /**
+     * @return Whether `position()` is a line number.
+     * This is `true` unless `ParserOptions::track_line_numbers = false`.
+     */
+    bool is_line() const {
+        return my_is_line;
+    }
+
+    /**
+     * @return If `is_line()` is true, the 1-based line number of the error.
+     * Otherwise, the 0-based byte offset of the error from the start of the file.
+     */
+    unsigned long long position() const {
+        return my_position;
+    }
+};
+
+}
+
+#endif
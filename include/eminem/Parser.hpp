@@ -6,17 +6,32 @@
 #include <complex>
 #include <type_traits>
 #include <stdexcept>
+#include <exception>
 #include <memory>
+#include <memory_resource>
 #include <thread>
 #include <mutex>
 #include <condition_variable>
+#include <functional>
 #include <limits>
+#include <algorithm>
 #include <iostream>
+#include <utility>
+#include <cstdint>
+#include <cstring>
+#include <charconv>
+#include <cmath>
+#include <cfenv>
+#include <cstdlib>
 
 #include "byteme/byteme.hpp"
 #include "sanisizer/sanisizer.hpp"
 
 #include "utils.hpp"
+#include "Executor.hpp"
+#include "ParseError.hpp"
+#include "HalfFloat.hpp"
+#include "ParserStats.hpp"
 
 /**
  * @file Parser.hpp
@@ -26,6 +41,28 @@
 
 namespace eminem {
 
+/**
+ * @brief Progress of a scan, see `ParserOptions::progress`.
+ */
+struct ParserProgress {
+    /**
+     * Number of bytes consumed from the input, including the preamble.
+     * When `ParserOptions::num_threads > 1`, this includes bytes in chunks that have been extracted but not yet merged.
+     */
+    unsigned long long bytes_consumed = 0;
+
+    /**
+     * Number of data lines that have been passed to the `store` function,
+     * not including any line for which `store` threw an exception or returned `false`.
+     */
+    unsigned long long lines_parsed = 0;
+
+    /**
+     * Expected total number of data lines, see `Parser::get_nlines()`.
+     */
+    unsigned long long expected_lines = 0;
+};
+
 /**
  * @brief Options for the `Parser` constructor.
  */
@@ -40,6 +77,59 @@ struct ParserOptions {
      * This is also used as the approximate size of the block to be processed by each thread, rounded up to the nearest newline before parallel processing.
      */
     std::size_t buffer_size = sanisizer::cap<std::size_t>(65536);
+
+    /**
+     * Executor to run the parsing jobs when `num_threads > 1`.
+     * This can be shared across multiple `Parser` instances to avoid the cost of creating new threads in each scan.
+     * In such cases, `num_threads` is only used to determine the maximum number of chunks that are processed by the executor at any given time.
+     * If not provided, a new `PersistentThreadPool` is created with `num_threads` threads in each call to `Parser::scan_integer()` (or related methods).
+     */
+    std::shared_ptr<Executor> executor;
+
+    /**
+     * Maximum number of bytes of parsed-but-unmerged data when `num_threads > 1`.
+     * This includes the buffered bytes for each chunk as well as the parsed values for that chunk that have yet to be passed to the `store` function.
+     * Once this limit is exceeded, no new chunks are dispatched until the existing chunks are merged, even if threads are available.
+     * This provides an upper bound on memory usage when `store` is slow, e.g., due to expensive processing or insertion into a complex data structure.
+     * At least one chunk is always processed regardless of the limit, so the effective limit is the larger of this value and the memory usage of a single chunk.
+     * If zero, no limit is applied.
+     */
+    std::size_t max_inflight_bytes = 0;
+
+    /**
+     * Memory resource to use for allocating the buffers and parsed values of each chunk when `num_threads > 1`.
+     * This can be set to a pooling resource like `std::pmr::synchronized_pool_resource` to re-use memory across scans and `Parser` instances,
+     * or to a `HugePageResource` to reduce the number of page faults for large buffers.
+     * The resource should outlive the `Parser`.
+     * If `NULL`, the default memory resource is used, see `std::pmr::get_default_resource()`.
+     */
+    std::pmr::memory_resource* memory_resource = NULL;
+
+    /**
+     * Whether to keep track of line numbers when scanning the data lines, for use in error messages.
+     * If `false`, errors in the data lines are reported with the byte offset from the start of the file instead of the line number.
+     * This avoids the per-line bookkeeping in the parsing loop and, when `num_threads > 1`, an extra pass over each chunk to count its newlines.
+     * Errors in the preamble are always reported with the line number.
+     */
+    bool track_line_numbers = true;
+
+    /**
+     * Function to report the progress of each call to `Parser::scan_integer()` (or related methods), e.g., to show that a long-running scan is not stuck.
+     * This is called on the thread that called the scan method:
+     *
+     * - When `num_threads > 1`, this is called after the parsed values of each chunk are passed to the `store` function.
+     * - When `num_threads = 1`, this is called after at least `progress_interval` bytes have been consumed since the previous call.
+     *   (Specifically, the number of consumed bytes is only checked once every few thousand lines.)
+     *
+     * It is also called once at the end of a scan that was not terminated early.
+     * If empty, no progress is reported, and the cost of checking this function is negligible.
+     */
+    std::function<void(const ParserProgress&)> progress;
+
+    /**
+     * Minimum number of bytes to consume between calls to `progress` when `num_threads = 1`.
+     */
+    unsigned long long progress_interval = 16777216;
 };
 
 /**
@@ -48,107 +138,145 @@ struct ParserOptions {
 template<typename Input_>
 using I = std::remove_reference_t<std::remove_cv_t<Input_> >;
 
-template<typename Workspace_>
+template<typename Workspace_, class Stats_ = NoStats>
 class ThreadPool {
 public:
     template<typename RunJob_>
-    ThreadPool(RunJob_ run_job, const int num_threads) :
-        my_helpers(sanisizer::as_size_type<I<decltype(my_helpers)> >(num_threads)) 
+    ThreadPool(RunJob_ run_job, const int num_threads, Executor* executor, std::size_t max_inflight_bytes, std::pmr::memory_resource* resource, Stats_* stats = NULL) :
+        my_run_job(std::move(run_job)),
+        my_executor(executor),
+        my_max_inflight_bytes(max_inflight_bytes),
+        my_stats(stats)
     {
-        std::mutex init_mut;
-        std::condition_variable init_cv;
-        int num_initialized = 0;
-
-        my_threads.reserve(num_threads);
-        for (int t = 0; t < num_threads; ++t) {
-            // Copy lambda as it will be gone once this constructor finishes.
-            my_threads.emplace_back([run_job,this,&init_mut,&init_cv,&num_initialized](int thread) -> void { 
-                Helper env; // allocating this locally within each thread to reduce the risk of false sharing.
-                my_helpers[thread] = &env;
-
-                {
-                    std::lock_guard lck(init_mut);
-                    ++num_initialized;
-                }
-                init_cv.notify_one(); // only notify once the lock is released for optimal performance.
-
-                while (1) {
-                    std::unique_lock lck(env.mut);
-                    env.cv.wait(lck, [&]() -> bool { return env.input_ready; });
-                    if (env.terminated) {
-                        return;
-                    }
-                    env.input_ready = false;
-
-                    try {
-                        run_job(env.work);
-                    } catch (...) {
-                        std::lock_guard elck(my_error_mut);
-                        if (!my_error) {
-                            my_error = std::current_exception();
-                        }
-                    }
-
-                    env.has_output = true;
-                    env.available = true;
-                    lck.unlock(); // again, only notify once the lock is released.
-                    env.cv.notify_one();
-                }
-            }, t);
+        if (my_executor == NULL) {
+            my_own_executor.reset(new PersistentThreadPool(num_threads));
+            my_executor = my_own_executor.get();
         }
 
-        // Only returning once all threads (and their specific mutexes) are initialized.
-        {
-            std::unique_lock ilck(init_mut);
-            init_cv.wait(ilck, [&]() -> bool { return num_initialized == num_threads; });
+        my_helpers.reserve(sanisizer::as_size_type<I<decltype(my_helpers)> >(num_threads));
+        for (int t = 0; t < num_threads; ++t) {
+            // Allocating each helper separately to reduce the risk of false sharing.
+            my_helpers.emplace_back(std::make_unique<Helper>(resource));
         }
     }
 
     ~ThreadPool() {
-        for (auto envptr : my_helpers) {
+        // Waiting for all submitted jobs to finish, as they hold references to the helpers.
+        // This is necessary if we exited run() early, e.g., due to an error or an early quit from the merge job.
+        for (auto& envptr : my_helpers) {
             auto& env = *envptr;
-            {
-                std::lock_guard lck(env.mut);
-                env.terminated = true;
-                env.input_ready = true;
-            }
-            env.cv.notify_one();
+            std::unique_lock lck(env.mut);
+            env.cv.wait(lck, [&]() -> bool { return !env.running; });
         }
-        for (auto& thread : my_threads) {
-            thread.join();
+
+        // All jobs have finished at this point, so the per-helper timings are final.
+        if constexpr(timed) {
+            if (my_stats) {
+                my_stats->merge_seconds += my_merge_seconds;
+                for (const auto& envptr : my_helpers) {
+                    my_stats->worker_parse_seconds.push_back(envptr->parse_seconds);
+                    my_stats->worker_idle_seconds.push_back(envptr->idle_seconds);
+                }
+            }
         }
     }
 
 private:
-    std::vector<std::thread> my_threads;
+    static constexpr bool timed = !std::is_same<Stats_, NoStats>::value;
+
+    std::function<void(Workspace_&)> my_run_job;
+    Executor* my_executor;
+    std::unique_ptr<Executor> my_own_executor;
+    std::size_t my_max_inflight_bytes;
+    Stats_* my_stats;
+    double my_merge_seconds = 0;
 
     struct Helper {
+        Helper(std::pmr::memory_resource* resource) : work(resource) {}
         std::mutex mut;
         std::condition_variable cv;
-        bool input_ready = false;
-        bool available = true;
+        bool running = false;
         bool has_output = false;
-        bool terminated = false;
+        std::size_t charge = 0;
         Workspace_ work;
+
+        // Only used if 'timed = true'.
+        double parse_seconds = 0;
+        double idle_seconds = 0;
+        bool has_finished = false;
+        StatsClock::time_point last_finish;
     };
-    std::vector<Helper*> my_helpers;
+    std::vector<std::unique_ptr<Helper> > my_helpers;
 
     std::mutex my_error_mut;
     std::exception_ptr my_error;
 
+    static std::size_t footprint(const Workspace_& work) {
+        return work.buffer.capacity() + work.contents.capacity() * sizeof(typename I<decltype(work.contents)>::value_type);
+    }
+
+    void submit(Helper& env) {
+        env.running = true;
+        my_executor->submit([this,&env]() -> void {
+            StatsClock::time_point start;
+            if constexpr(timed) {
+                start = StatsClock::now();
+                if (env.has_finished) {
+                    env.idle_seconds += std::chrono::duration<double>(start - env.last_finish).count();
+                }
+                if (my_stats) {
+                    my_stats->start_phase(ParserPhase::PARSE);
+                }
+            }
+
+            try {
+                my_run_job(env.work);
+            } catch (...) {
+                std::lock_guard elck(my_error_mut);
+                if (!my_error) {
+                    my_error = std::current_exception();
+                }
+            }
+
+            if constexpr(timed) {
+                if (my_stats) {
+                    my_stats->end_phase(ParserPhase::PARSE);
+                }
+                env.last_finish = StatsClock::now();
+                env.parse_seconds += std::chrono::duration<double>(env.last_finish - start).count();
+                env.has_finished = true;
+            }
+
+            // Notifying while holding the lock, as the ThreadPool (and thus 'env') might be destroyed immediately after the lock is released.
+            std::lock_guard lck(env.mut);
+            env.has_output = true;
+            env.running = false;
+            env.cv.notify_one();
+        });
+    }
+
 public:
     template<typename CreateJob_, typename MergeJob_>
     bool run(CreateJob_ create_job, MergeJob_ merge_job) {
-        const auto num_threads = my_threads.size();
+        const auto num_threads = my_helpers.size();
         bool finished = false;
         I<decltype(num_threads)> thread = 0, finished_count = 0;
 
-        // We submit jobs by cycling through all threads, then we merge their results in order of submission.
+        // Memory usage of the in-flight chunks is estimated from the size of each chunk's buffer,
+        // scaled by the largest ratio of memory usage to buffer size in the chunks that were already merged.
+        std::size_t inflight_bytes = 0, largest_chunk = 0;
+        double expansion = 1;
+
+        // We submit jobs by cycling through all helpers, then we merge their results in order of submission.
         // This is a less efficient worksharing scheme but it guarantees the same order of merges.
+        // It also ensures that each scan has no more than 'num_threads' jobs in the executor at any given time,
+        // which allows for fair scheduling when the executor is shared between multiple concurrent scans.
         while (1) {
             auto& env = *(my_helpers[thread]);
-            std::unique_lock lck(env.mut);
-            env.cv.wait(lck, [&]() -> bool { return env.available; });
+            {
+                std::unique_lock lck(env.mut);
+                env.cv.wait(lck, [&]() -> bool { return !env.running; });
+            }
 
             {
                 std::lock_guard elck(my_error_mut);
@@ -156,16 +284,35 @@ public:
                     std::rethrow_exception(my_error);
                 }
             }
-            env.available = false;
 
             if (env.has_output) {
+                if (my_max_inflight_bytes && env.work.buffer.size()) {
+                    expansion = std::max(expansion, static_cast<double>(footprint(env.work)) / env.work.buffer.size());
+                }
+
                 // If the user requests an early quit from the merge job,
                 // there's no point processing the later merge jobs from 
                 // other threads, so we just break out at this point.
-                if (!merge_job(env.work)) {
+                bool keep_going;
+                if constexpr(timed) {
+                    if (my_stats) {
+                        my_stats->start_phase(ParserPhase::MERGE);
+                    }
+                    const auto start = StatsClock::now();
+                    keep_going = merge_job(env.work);
+                    my_merge_seconds += seconds_since(start);
+                    if (my_stats) {
+                        my_stats->end_phase(ParserPhase::MERGE);
+                    }
+                } else {
+                    keep_going = merge_job(env.work);
+                }
+                if (!keep_going) {
                     return false;
                 }
                 env.has_output = false;
+                inflight_bytes -= env.charge;
+                env.charge = 0;
             }
 
             if (finished) {
@@ -174,11 +321,21 @@ public:
                 if (finished_count == num_threads) {
                     break;
                 }
+
+            } else if (my_max_inflight_bytes && inflight_bytes && inflight_bytes + largest_chunk * expansion > my_max_inflight_bytes) {
+                // Leaving this helper idle until the other chunks are merged.
+                // Skipping a helper does not change the order of merges, as the next chunk will be submitted to the next helper in the cycle.
+                // Its buffers keep their capacity for re-use in its next chunk; idle helpers have no charge so they do not count towards 'inflight_bytes'.
+
             } else {
                 finished = !create_job(env.work);
-                env.input_ready = true;
-                lck.unlock();
-                env.cv.notify_one();
+                if (my_max_inflight_bytes) {
+                    const auto bufsize = env.work.buffer.size();
+                    largest_chunk = std::max(largest_chunk, bufsize);
+                    env.charge = std::max(static_cast<double>(bufsize) * expansion, static_cast<double>(footprint(env.work)));
+                    inflight_bytes += env.charge;
+                }
+                submit(env);
             }
 
             ++thread;
@@ -191,6 +348,131 @@ public:
     }
 };
 
+// Mimics the byteme::SerialBufferedReader interface, but extract() reads directly from the source into the output buffer.
+// This ensures that each byte is only copied once when filling the per-thread buffers in parallel mode,
+// rather than being copied into our buffer and then again into the per-thread buffer.
+template<class ReaderPointer_, class Stats_ = NoStats>
+class SourceReader {
+public:
+    SourceReader(ReaderPointer_ source, std::size_t buffer_size) : 
+        my_source(std::move(source)),
+        my_buffer(sanisizer::as_size_type<I<decltype(my_buffer)> >(std::max(static_cast<std::size_t>(1), buffer_size)))
+    {
+        refill(my_buffer.size());
+    }
+
+private:
+    ReaderPointer_ my_source;
+    std::vector<char> my_buffer;
+    std::size_t my_available = 0;
+    std::size_t my_position = 0;
+    unsigned long long my_consumed = 0; // number of bytes before the start of my_buffer.
+    bool my_finished = false;
+    Stats_* my_stats = NULL; // only used if 'timed = true'.
+
+    static constexpr bool timed = !std::is_same<Stats_, NoStats>::value;
+
+    std::size_t read(char* output, std::size_t n) {
+        if constexpr(timed) {
+            if (my_stats) {
+                my_stats->start_phase(ParserPhase::EXTRACT);
+                const auto start = StatsClock::now();
+                const auto filled = read_untimed(output, n);
+                my_stats->extract_seconds += seconds_since(start);
+                my_stats->end_phase(ParserPhase::EXTRACT);
+                return filled;
+            }
+        }
+        return read_untimed(output, n);
+    }
+
+    std::size_t read_untimed(char* output, std::size_t n) {
+        std::size_t filled = 0;
+        while (filled < n && !my_finished) {
+            auto got = my_source->read(reinterpret_cast<unsigned char*>(output + filled), n - filled);
+            if (got == 0) {
+                my_finished = true;
+            }
+            filled += got;
+        }
+        return filled;
+    }
+
+    void refill(std::size_t n) {
+        my_consumed += my_available;
+        my_available = read(my_buffer.data(), n);
+        my_position = 0;
+    }
+
+public:
+    char get() const {
+        return my_buffer[my_position];
+    }
+
+    bool valid() const {
+        return my_position < my_available;
+    }
+
+    bool advance() {
+        ++my_position;
+        if (my_position < my_available) {
+            return true;
+        }
+        refill(my_buffer.size());
+        return valid();
+    }
+
+    unsigned long long position() const {
+        return my_consumed + my_position;
+    }
+
+    // Each read from the source is counted towards the extraction phase of 'stats', if not NULL.
+    // This is only used in serial scans, as the reads in parallel scans are part of each chunk's extraction.
+    void set_stats(Stats_* stats) {
+        my_stats = stats;
+    }
+
+    // Contiguous view of the remaining bytes in the buffer, for kernels that process multiple bytes at once.
+    const char* data() const {
+        return my_buffer.data() + my_position;
+    }
+
+    std::size_t available() const {
+        return my_available - my_position;
+    }
+
+    // Equivalent to calling advance() 'n' times, where 'n' is no greater than available().
+    bool skip(std::size_t n) {
+        my_position += n;
+        if (my_position < my_available) {
+            return true;
+        }
+        refill(my_buffer.size());
+        return valid();
+    }
+
+    std::pair<std::size_t, bool> extract(std::size_t n, char* output) {
+        const auto leftover = std::min(n, my_available - my_position);
+        std::copy_n(my_buffer.data() + my_position, leftover, output);
+        my_position += leftover;
+
+        std::size_t direct = 0;
+        if (leftover < n) {
+            direct = read(output + leftover, n - leftover);
+            my_consumed += direct;
+        }
+
+        if (my_position == my_available) {
+            // Only partially refilling our buffer, as the caller typically only needs a few bytes to reach the next newline.
+            // This avoids copying most of the next chunk through our buffer, which would defeat the purpose of reading directly into 'output'.
+            // If more bytes are needed, the next advance() will perform a full refill.
+            refill(std::min(my_buffer.size(), static_cast<std::size_t>(256)));
+        }
+
+        return std::make_pair(leftover + direct, valid());
+    }
+};
+
 // Mimics parts of the BufferedReader interface,
 // but just uses an existing buffer rather than making and filling another vector.
 // This allows each thread to directly operate on its own buffer after calling BufferedReader::extract(). 
@@ -216,10 +498,27 @@ public:
         ++my_position;
         return valid();
     }
+
+    std::size_t position() const {
+        return my_position;
+    }
+
+    const char* data() const {
+        return my_buffer + my_position;
+    }
+
+    std::size_t available() const {
+        return my_len - my_position;
+    }
+
+    bool skip(std::size_t n) {
+        my_position += n;
+        return valid();
+    }
 };
 
-template<class Input_>
-bool fill_to_next_newline(Input_& input, std::vector<char>& buffer, std::size_t buffer_size) {
+template<class Input_, class Buffer_>
+bool fill_to_next_newline(Input_& input, Buffer_& buffer, std::size_t buffer_size) {
     buffer.resize(buffer_size);
     auto done = input.extract(buffer_size, buffer.data());
     buffer.resize(done.first);
@@ -237,7 +536,8 @@ bool fill_to_next_newline(Input_& input, std::vector<char>& buffer, std::size_t
     return true;
 }
 
-inline std::size_t count_newlines(const std::vector<char>& buffer) {
+template<class Buffer_>
+std::size_t count_newlines(const Buffer_& buffer) {
     std::size_t n = 0;
     for (auto x : buffer) {
         n += (x == '\n');
@@ -245,7 +545,194 @@ inline std::size_t count_newlines(const std::vector<char>& buffer) {
     return n;
 }
 
+// Checks whether a chunk consists solely of data lines with single-space separators,
+// i.e., no comments, blank lines, tabs, CRs, or leading/trailing/repeated spaces.
+// If so, the per-line handling of comments and variable whitespace can be skipped for the entire chunk.
+// This is written as a single branchless pass so that the compiler can vectorize it.
+template<class Buffer_>
+bool is_well_formed_chunk(const Buffer_& buffer) {
+    const std::size_t n = buffer.size();
+    if (n == 0) {
+        return true;
+    }
+    const char* ptr = buffer.data();
+    if (ptr[0] == ' ' || ptr[0] == '\n' || ptr[n - 1] == ' ') {
+        return false;
+    }
+
+    unsigned char bad = (ptr[0] == '%') | (ptr[0] == '\t') | (ptr[0] == '\r');
+    for (std::size_t i = 1; i < n; ++i) {
+        const char prev = ptr[i - 1], x = ptr[i];
+        const unsigned char prev_blank = (prev == ' ') | (prev == '\n');
+        const unsigned char blank = (x == ' ') | (x == '\n');
+        bad |= (prev_blank & blank) | (x == '%') | (x == '\t') | (x == '\r');
+    }
+    return !bad;
+}
+
+// Kernel for data lines that consist solely of unsigned integer fields separated by single spaces, e.g., "12345 678 3\n".
+// These make up the overwhelming majority of lines in pattern and integer coordinate files (e.g., for single-cell data),
+// so we parse them in a single pass over a contiguous block of bytes, using SWAR (i.e., "SIMD within a register") on 8-byte words
+// to find the end of each field and to convert all of its digits at once.
+// Anything unusual - comments, signs, CR, tabs, extra spaces, fields with more than 15 digits, values that do not fit in the output type,
+// or lines that are not entirely contained in the block - causes the kernel to report failure, in which case the caller uses the general parser.
+#if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+constexpr bool fast_line_kernel_available = true;
+#else
+constexpr bool fast_line_kernel_available = false; // the digit conversion assumes little-endian loads.
+#endif
+
+inline std::uint64_t load_word(const char* ptr) {
+    std::uint64_t word;
+    std::memcpy(&word, ptr, sizeof(word));
+    return word;
+}
+
+// Sets the high bit of each byte of 'word' that is not an ASCII digit.
+// Only the lowest flagged byte is reliable, as the addition may carry out of a non-digit byte into the next byte;
+// this is fine as we only care about the first non-digit.
+inline std::uint64_t nondigit_mask(std::uint64_t word) {
+    const std::uint64_t x = word ^ 0x3030303030303030ull; // digits become 0-9, everything else becomes >= 10.
+    return ((x + 0x7676767676767676ull) | x) & 0x8080808080808080ull;
+}
+
+inline int first_flagged_byte(std::uint64_t mask) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(mask) / 8;
+#else
+    int i = 0;
+    while (!(mask & 0x80)) {
+        mask >>= 8;
+        ++i;
+    }
+    return i;
+#endif
+}
+
+// Converts the first 'n' digits of 'word' (0 < n <= 8), where the first digit is the most significant.
+inline std::uint64_t convert_digits(std::uint64_t word, int n) {
+    word <<= 8 * (8 - n); // discarding everything after the digits; the vacated low bytes act as leading zeros.
+    word = ((word & 0x0F0F0F0F0F0F0F0Full) * 2561) >> 8; // pairs of digits.
+    word = ((word & 0x00FF00FF00FF00FFull) * 6553601) >> 16; // groups of 4 digits.
+    return (((word & 0x0000FFFF0000FFFFull) * 42949672960001ull) >> 32) & 0xFFFFFFFFull;
+}
+
+// Parses a field of 1-15 digits at 'ptr[position]' that is terminated by 'terminator'.
+// On success, the value is stored in 'output' and 'position' is moved past the terminator.
+template<typename Integer_>
+bool parse_fast_field(const char* ptr, std::size_t available, std::size_t& position, char terminator, Integer_& output) {
+    if (available - position < 16) {
+        return false;
+    }
+
+    const auto first = load_word(ptr + position);
+    const auto first_mask = nondigit_mask(first);
+    std::uint64_t value;
+    int ndigits;
+
+    if (first_mask) {
+        ndigits = first_flagged_byte(first_mask);
+        if (ndigits == 0) {
+            return false;
+        }
+        value = convert_digits(first, ndigits);
+
+    } else {
+        const auto second = load_word(ptr + position + 8);
+        const auto second_mask = nondigit_mask(second);
+        if (!second_mask) {
+            return false;
+        }
+        const int extra = first_flagged_byte(second_mask);
+        value = convert_digits(first, 8);
+        if (extra) {
+            std::uint64_t scale = 1;
+            for (int e = 0; e < extra; ++e) {
+                scale *= 10;
+            }
+            value = value * scale + convert_digits(second, extra);
+        }
+        ndigits = 8 + extra;
+    }
+
+    if (ptr[position + ndigits] != terminator) {
+        return false;
+    }
+    if (value > static_cast<std::uint64_t>(std::numeric_limits<Integer_>::max())) {
+        return false; // leave it to the general parser to report the overflow.
+    }
+
+    output = static_cast<Integer_>(value);
+    position += ndigits + 1;
+    return true;
+}
+
+// Parses a line of a pattern coordinate matrix, returning the number of bytes in the line (including the newline).
+// Zero is returned if the line needs to be handled by the general parser.
+template<typename Index_>
+std::size_t parse_fast_coordinate_line(const char* ptr, std::size_t available, Index_& row, Index_& column) {
+    std::size_t position = 0;
+    if (!parse_fast_field(ptr, available, position, ' ', row) || !parse_fast_field(ptr, available, position, '\n', column)) {
+        return 0;
+    }
+    return position;
+}
+
+// Same as above, for a line of an integer coordinate matrix.
+template<typename Index_, typename Value_>
+std::size_t parse_fast_coordinate_line(const char* ptr, std::size_t available, Index_& row, Index_& column, Value_& value) {
+    std::size_t position = 0;
+    if (
+        !parse_fast_field(ptr, available, position, ' ', row) ||
+        !parse_fast_field(ptr, available, position, ' ', column) ||
+        !parse_fast_field(ptr, available, position, '\n', value)
+    ) {
+        return 0;
+    }
+    return position;
+}
+
+// Stand-in for the line number when ParserOptions::track_line_numbers = false.
+// Increments are no-ops, and error messages report the byte offset of the input's current position instead.
+struct UntrackedLine {
+    unsigned long long offset = 0; // byte offset of the start of the input, e.g., for a chunk in parallel mode.
+    UntrackedLine& operator++() {
+        return *this;
+    }
+};
+
+#if defined(__GNUC__)
+#define EMINEM_COLD __attribute__((noinline, cold))
+#else
+#define EMINEM_COLD
+#endif
+
+[[noreturn]] EMINEM_COLD inline void raise_parse_error(ParseErrorCode code, const char* message, bool is_line, unsigned long long position) {
+    std::string full(message);
+    if (is_line) {
+        full += " on line " + std::to_string(position);
+    } else {
+        full += " at byte offset " + std::to_string(position);
+    }
+    throw ParseError(code, full, is_line, position);
+}
+
 typedef unsigned long long Index; // for back-compatibility.
+
+template<Field field_>
+struct DefaultFieldType {
+    typedef double type;
+};
+
+template<>
+struct DefaultFieldType<Field::INTEGER> {
+    typedef int type;
+};
+
+template<>
+struct DefaultFieldType<Field::PATTERN> {
+    typedef bool type;
+};
 /**
  * @endcond
  */
@@ -262,6 +749,9 @@ typedef unsigned long long LineIndex;
  * @tparam ReaderPointer_ Class of the source of input bytes.
  * This should be a smart or raw pointer to an object satisfying the `byteme::Reader` instance.
  * @tparam Index_ Integer type of the row/column indices.
+ * @tparam Stats_ Policy for collecting statistics in each scan, either `NoStats` or `ParserStats` (or a subclass thereof).
+ * For `NoStats`, all bookkeeping is compiled away.
+ * For `ParserStats`, the statistics for the most recent scan can be retrieved with `get_stats()`.
  *
  * This parses a Matrix Market file according to the specification described at https://math.nist.gov/MatrixMarket/reports/MMformat.ps.gz.
  * It is expected that users call `scan_preamble()` to determine the field type (see `eminem::Field` for supported values),
@@ -301,9 +791,23 @@ typedef unsigned long long LineIndex;
  * 
  * No validation is performed to determine whether coordinates are consistent with non-general symmetries.
  * Similarly, we do not check for the existence of multiple lines with the same row/column indices in coordinate matrices/vectors.
+ *
+ * Errors in the size line or the data lines are reported by throwing a `ParseError`, which contains the type and location of the error.
  */
-template<class ReaderPointer_, typename Index_ = unsigned long long>
+template<class ReaderPointer_, typename Index_ = unsigned long long, class Stats_ = NoStats>
 class Parser {
+    static_assert(std::is_same<Stats_, NoStats>::value || std::is_base_of<ParserStats, Stats_>::value);
+    static constexpr bool collect_stats = !std::is_same<Stats_, NoStats>::value;
+
+    /**
+     * @cond
+     */
+    // Defined by perf/src/benchmark_kernels.cpp to run the private parsing kernels in isolation.
+    friend struct ParserKernelBenchmark;
+    /**
+     * @endcond
+     */
+
 public:
     /**
      * @param input Source of input bytes, typically a pointer to a `byteme::Reader` instance.
@@ -312,18 +816,38 @@ public:
     Parser(ReaderPointer_ input, const ParserOptions& options) : 
         my_input(std::move(input), options.buffer_size),
         my_nthreads(options.num_threads),
-        my_buffer_size(options.buffer_size)
+        my_buffer_size(options.buffer_size),
+        my_executor(options.executor),
+        my_max_inflight_bytes(options.max_inflight_bytes),
+        my_memory_resource(options.memory_resource == NULL ? std::pmr::get_default_resource() : options.memory_resource),
+        my_track_lines(options.track_line_numbers),
+        my_progress(options.progress),
+        my_progress_interval(options.progress_interval)
     {
         sanisizer::as_size_type<std::vector<char> >(my_buffer_size); // checking that there won't be any overflow in fill_to_next_newline().
     }
 
 private:
-    // Hard-coding a serial reader here, because if parallelization was available, it's better to use the extra threads for parsing.
-    byteme::SerialBufferedReader<char, ReaderPointer_> my_input;
+    // Reads from the byteme::Reader on the calling thread, buffering the bytes for the preamble and the serial scans.
+    // In parallel scans, each chunk is read by SourceReader::extract() directly into the per-thread buffer (after any bytes that are already buffered), see fill_chunk().
+    // Reading is never parallelized as any extra threads are better used for parsing.
+    SourceReader<ReaderPointer_, Stats_> my_input;
     int my_nthreads;
     std::size_t my_buffer_size;
+    std::shared_ptr<Executor> my_executor;
+    std::size_t my_max_inflight_bytes;
+    std::pmr::memory_resource* my_memory_resource;
+    bool my_track_lines;
+    bool my_all_integral = true;
+    Stats_ my_stats;
+
+    std::function<void(const ParserProgress&)> my_progress;
+    unsigned long long my_progress_interval;
+    LineIndex my_next_progress_check = 0;
+    unsigned long long my_last_progress_bytes = 0;
 
     LineIndex my_current_line = 0;
+    UntrackedLine my_untracked_line;
     MatrixDetails my_details;
 
     template<typename Input2_>
@@ -350,8 +874,8 @@ private:
         return chomp(input);
     }
 
-    template<typename Input2_>
-    static bool skip_lines(Input2_& input, LineIndex& current_line) {
+    template<typename Input2_, class Line_>
+    static bool skip_lines(Input2_& input, Line_& current_line) {
         // Skip comments and empty lines.
         while (1) {
             char x = input.get();
@@ -373,6 +897,18 @@ private:
         return true;
     }
 
+    // The kernels only need to pass a code and a position when an error is encountered.
+    // The message and the exception are constructed out-of-line in raise_parse_error(), keeping the parsing loops small.
+    template<typename Input2_>
+    [[noreturn]] static void throw_parse_error(ParseErrorCode code, const char* message, const Input2_&, LineIndex current_line) {
+        raise_parse_error(code, message, true, current_line + 1);
+    }
+
+    template<typename Input2_>
+    [[noreturn]] static void throw_parse_error(ParseErrorCode code, const char* message, const Input2_& input, const UntrackedLine& current_line) {
+        raise_parse_error(code, message, false, current_line.offset + input.position());
+    }
+
 private:
     bool my_passed_banner = false;
 
@@ -634,19 +1170,11 @@ private:
     template<bool last_, typename Integer_>
     using SizeInfo = typename std::conditional<last_, LastSizeInfo<Integer_>, NotLastSizeInfo<Integer_> >::type;
 
-    template<bool last_, typename Integer_, class Input2_>
-    static SizeInfo<last_, Integer_> scan_integer_field(bool size, Input2_& input, LineIndex overall_line_count) {
+    template<bool last_, typename Integer_, class Input2_, class Line_>
+    static SizeInfo<last_, Integer_> scan_integer_field(bool size, Input2_& input, Line_ overall_line_count) {
         SizeInfo<last_, Integer_> output;
         bool found = false;
 
-        auto what = [&]() -> std::string {
-            if (size) {
-                return "size";
-            } else {
-                return "index";
-            }
-        };
-
         constexpr Integer_ max_limit = std::numeric_limits<Integer_>::max();
         constexpr Integer_ max_limit_before_mult = max_limit / 10; 
         constexpr Integer_ max_limit_mod = max_limit % 10; 
@@ -659,7 +1187,7 @@ private:
                         Integer_ delta = x - '0';
                         // Structuring the conditionals so that it's most likely to short-circuit after only testing the first one.
                         if (output.index >= max_limit_before_mult && !(output.index == max_limit_before_mult && delta <= max_limit_mod)) {
-                            throw std::runtime_error("integer overflow in " + what() + " field on line " + std::to_string(overall_line_count + 1));
+                            throw_parse_error(ParseErrorCode::VALUE_OVERFLOW, (size ? "integer overflow in size field" : "integer overflow in index field"), input, overall_line_count);
                         }
                         output.index *= 10;
                         output.index += delta;
@@ -673,37 +1201,37 @@ private:
                     // - a non-newline non-digit, in case we throw.
                     // - a newline, in which case we arrive here.
                     if (!found) {
-                        throw std::runtime_error("empty " + what() + " field on line " + std::to_string(overall_line_count + 1));
+                        throw_parse_error(ParseErrorCode::EMPTY_FIELD, (size ? "empty size field" : "empty index field"), input, overall_line_count);
                     }
                     if constexpr(last_) {
                         output.remaining = input.advance(); // advance past the newline.
                         return output;
                     }
-                    throw std::runtime_error("unexpected newline when parsing " + what() + " field on line " + std::to_string(overall_line_count + 1));
+                    throw_parse_error(ParseErrorCode::MISSING_FIELD, (size ? "unexpected newline when parsing size field" : "unexpected newline when parsing index field"), input, overall_line_count);
                 case ' ': case '\t': case '\r':
                     if (!advance_and_chomp(input)) { // skipping the current and subsequent blanks.
                         if constexpr(last_) {
                             return output;
                         } else {
-                            throw std::runtime_error("unexpected end of file when parsing " + what() + " field on line " + std::to_string(overall_line_count + 1));
+                            throw_parse_error(ParseErrorCode::MISSING_FIELD, (size ? "unexpected end of file when parsing size field" : "unexpected end of file when parsing index field"), input, overall_line_count);
                         }
                     }
                     if constexpr(last_) {
                         if (input.get() != '\n') {
-                            throw std::runtime_error("expected newline after the last " + what() + " field on line " + std::to_string(overall_line_count + 1));
+                            throw_parse_error(ParseErrorCode::EXTRA_FIELD, (size ? "expected newline after the last size field" : "expected newline after the last index field"), input, overall_line_count);
                         }
                         output.remaining = input.advance(); // advance past the newline.
                     }
                     return output;
                 default:
-                    throw std::runtime_error("unexpected character when parsing " + what() + " field on line " + std::to_string(overall_line_count + 1));
+                    throw_parse_error(ParseErrorCode::INVALID_VALUE, (size ? "unexpected character when parsing size field" : "unexpected character when parsing index field"), input, overall_line_count);
             }
 
             if (!(input.advance())) { // moving past the current digit.
                 if constexpr(last_) {
                     break;
                 } else {
-                    throw std::runtime_error("unexpected end of file when parsing " + what() + " field on line " + std::to_string(overall_line_count + 1));
+                    throw_parse_error(ParseErrorCode::MISSING_FIELD, (size ? "unexpected end of file when parsing size field" : "unexpected end of file when parsing index field"), input, overall_line_count);
                 }
             }
         }
@@ -711,18 +1239,18 @@ private:
         return output;
     }
 
-    template<bool last_, class Input2_>
-    static SizeInfo<last_, Index_> scan_size_field(Input2_& input, LineIndex overall_line_count) {
+    template<bool last_, class Input2_, class Line_>
+    static SizeInfo<last_, Index_> scan_size_field(Input2_& input, Line_ overall_line_count) {
         return scan_integer_field<last_, Index_>(true, input, overall_line_count);
     }
 
-    template<class Input2_>
-    static SizeInfo<true, LineIndex> scan_line_count_field(Input2_& input, LineIndex overall_line_count) {
+    template<class Input2_, class Line_>
+    static SizeInfo<true, LineIndex> scan_line_count_field(Input2_& input, Line_ overall_line_count) {
         return scan_integer_field<true, LineIndex>(true, input, overall_line_count);
     }
 
-    template<bool last_, class Input2_>
-    static SizeInfo<last_, Index_> scan_index_field(Input2_& input, LineIndex overall_line_count) {
+    template<bool last_, class Input2_, class Line_>
+    static SizeInfo<last_, Index_> scan_index_field(Input2_& input, Line_ overall_line_count) {
         return scan_integer_field<last_, Index_>(false, input, overall_line_count);
     }
 
@@ -741,7 +1269,7 @@ private:
             throw std::runtime_error("failed to find size line before end of file");
         }
         if (!chomp(my_input)) {
-            throw std::runtime_error("expected at least one size field on line " + std::to_string(my_current_line + 1));
+            throw_parse_error(ParseErrorCode::MISSING_FIELD, "expected at least one size field", my_input, my_current_line);
         }
 
         if (my_details.object == Object::MATRIX) {
@@ -827,6 +1355,32 @@ public:
         return my_nlines;
     }
 
+    /**
+     * Check whether all values in the most recent scan were written as integers, i.e., a sequence of digits with an optional sign,
+     * without a decimal point, exponent, `inf` or `nan`.
+     * This is primarily useful after `scan_real()` to determine whether the values could be stored in an integer type instead.
+     * It is always true after `scan_integer()` and `scan_pattern()`.
+     * If the scan terminated early, this only considers the values that were passed to the store function.
+     * (In parallel mode, this may also include values from some of the subsequent lines.)
+     *
+     * @return Whether all values were integers.
+     */
+    bool get_all_integral() const {
+        return my_all_integral;
+    }
+
+    /**
+     * Retrieve statistics for the most recent call to `scan_integer()` (or related methods).
+     * This is only available if `Stats_` is `ParserStats` or a subclass thereof.
+     * If the scan threw an error, the statistics may be incomplete.
+     *
+     * @return Statistics for the most recent scan.
+     */
+    const Stats_& get_stats() const {
+        static_assert(collect_stats, "statistics are only collected when Stats_ = ParserStats");
+        return my_stats;
+    }
+
 public:
     /**
      * Scan the preamble from the Matrix Market file, including the banner and the size line.
@@ -847,65 +1401,275 @@ private:
         bool remaining;
     };
 
+    template<class Buffer_>
+    bool fill_chunk(Buffer_& buffer) {
+        if constexpr(collect_stats) {
+            my_stats.start_phase(ParserPhase::EXTRACT);
+            const auto start = StatsClock::now();
+            bool available = fill_to_next_newline(my_input, buffer, my_buffer_size);
+            my_stats.extract_seconds += seconds_since(start);
+            my_stats.end_phase(ParserPhase::EXTRACT);
+            return available;
+        } else {
+            return fill_to_next_newline(my_input, buffer, my_buffer_size);
+        }
+    }
+
     template<typename Workspace_>
     bool configure_parallel_workspace(Workspace_& work) {
-        bool available = fill_to_next_newline(my_input, work.buffer, my_buffer_size);
-        work.contents.clear();
-        work.overall_line = my_current_line;
-        my_current_line += count_newlines(work.buffer);
-        return available;
+        if constexpr(std::is_same<I<decltype(work.overall_line)>, LineIndex>::value) {
+            bool available = fill_chunk(work.buffer);
+            work.contents.clear();
+            work.overall_line = my_current_line;
+            if constexpr(collect_stats) {
+                my_stats.start_phase(ParserPhase::COUNT_NEWLINES);
+                const auto start = StatsClock::now();
+                my_current_line += count_newlines(work.buffer);
+                my_stats.count_newlines_seconds += seconds_since(start);
+                my_stats.end_phase(ParserPhase::COUNT_NEWLINES);
+            } else {
+                my_current_line += count_newlines(work.buffer);
+            }
+            return available;
+        } else {
+            work.overall_line.offset = my_input.position(); // no need to count newlines, we only need the offset of the start of the chunk.
+            bool available = fill_chunk(work.buffer);
+            work.contents.clear();
+            return available;
+        }
     }
 
-    void check_num_lines_loop(LineIndex data_line_count) const {
-        if (data_line_count >= my_nlines) {
-            throw std::runtime_error("more lines present than specified in the header (" + std::to_string(data_line_count) + " versus " + std::to_string(my_nlines) + ")");
-        }
+    // In serial mode, the number of consumed bytes is only checked once every 'progress_check_lines' lines.
+    // When there is no progress function, the next check is set to the maximum so that it never happens.
+    static constexpr LineIndex progress_check_lines = 4096;
+
+    void report_progress(LineIndex data_line_count) {
+        ParserProgress progress;
+        progress.bytes_consumed = my_input.position();
+        progress.lines_parsed = data_line_count;
+        progress.expected_lines = my_nlines;
+        my_progress(progress);
     }
 
-    void check_num_lines_final(bool finished, LineIndex data_line_count) const {
-        if (finished) {
-            if (data_line_count != my_nlines) {
-                // Must be fewer, otherwise we would have triggered the error in check_num_lines_loop() during iteration.
-                throw std::runtime_error("fewer lines present than specified in the header (" + std::to_string(data_line_count) + " versus " + std::to_string(my_nlines) + ")");
+    void serial_progress(LineIndex data_line_count) {
+        if (data_line_count == my_next_progress_check) {
+            my_next_progress_check += progress_check_lines;
+            const auto current = my_input.position();
+            if (current - my_last_progress_bytes >= my_progress_interval) {
+                my_last_progress_bytes = current;
+                report_progress(data_line_count);
             }
         }
     }
 
-private:
-    void check_matrix_coordinate_line(Index_ currow, Index_ curcol, LineIndex overall_line_count) const {
-        if (!currow) {
-            throw std::runtime_error("row index must be positive on line " + std::to_string(overall_line_count + 1));
-        }
-        if (currow > my_nrows) {
-            throw std::runtime_error("row index out of range on line " + std::to_string(overall_line_count + 1));
-        }
-        if (!curcol) {
-            throw std::runtime_error("column index must be positive on line " + std::to_string(overall_line_count + 1));
-        }
-        if (curcol > my_ncols) {
-            throw std::runtime_error("column index out of range on line " + std::to_string(overall_line_count + 1));
+    void parallel_progress(LineIndex data_line_count) {
+        if (my_progress) {
+            report_progress(data_line_count);
         }
     }
 
-    template<typename Type_, class Input2_, typename FieldParser_, class WrappedStore_>
-    bool scan_matrix_coordinate_non_pattern_base(Input2_& input, LineIndex& overall_line_count, FieldParser_& fparser, WrappedStore_ wstore) const {
-        bool valid = input.valid();
-        while (valid) {
-            // Handling stray comments, empty lines, and leading spaces.
-            if (!skip_lines(input, overall_line_count)) {
-                break;
+    // Bookkeeping at the start and end of each scan of the data lines.
+    struct ScanStart {
+        StatsClock::time_point time;
+        unsigned long long position = 0;
+    };
+
+    ScanStart start_scan() {
+        my_all_integral = true;
+        my_next_progress_check = (my_progress ? progress_check_lines : std::numeric_limits<LineIndex>::max());
+        my_last_progress_bytes = my_input.position();
+
+        ScanStart output;
+        if constexpr(collect_stats) {
+            static_cast<ParserStats&>(my_stats) = ParserStats(); // leaving any members of a subclass to its start_phase().
+            my_stats.start_phase(ParserPhase::SCAN);
+            my_input.set_stats(my_nthreads == 1 ? &my_stats : NULL);
+            output.time = StatsClock::now();
+            output.position = my_input.position();
+        }
+        return output;
+    }
+
+    void finish_scan(const ScanStart& start, bool finished, LineIndex data_line_count) {
+        if (finished && my_progress) {
+            report_progress(data_line_count);
+        }
+
+        if constexpr(collect_stats) {
+            my_stats.bytes_read = my_input.position() - start.position;
+            my_stats.lines_parsed = data_line_count;
+            my_stats.total_seconds = seconds_since(start.time);
+            my_input.set_stats(NULL);
+            my_stats.end_phase(ParserPhase::SCAN);
+        } else {
+            (void)start;
+            (void)data_line_count;
+        }
+    }
+
+    // Line counters for the serial scans.
+    LineIndex& serial_line(LineIndex) {
+        return my_current_line;
+    }
+
+    UntrackedLine& serial_line(UntrackedLine) {
+        return my_untracked_line;
+    }
+
+    template<class Function_>
+    bool dispatch_line_tracking(Function_ fun) {
+        if (my_track_lines) {
+            return fun(LineIndex());
+        } else {
+            return fun(UntrackedLine());
+        }
+    }
+
+    // Batched equivalent of calling check_num_lines_loop() before storing each line of a chunk in the merge step.
+    // This returns the number of entries that can be stored before the expected number of lines is exceeded;
+    // if this is less than the chunk size, check_num_lines_loop() should be called after storing those entries, which will throw.
+    std::size_t check_num_lines_chunk(LineIndex data_line_count, std::size_t chunk_size) const {
+        const LineIndex remaining = my_nlines - data_line_count; // data_line_count <= my_nlines is guaranteed by previous checks.
+        return (chunk_size > remaining ? remaining : chunk_size);
+    }
+
+    // In parallel mode, the indices are checked for the entire chunk at once, which is more efficient than checking each line.
+    // If this fails, or if any other error occurs, we re-parse the chunk with the per-line checks to throw the first error at its exact location.
+    template<class Parse_, class Validate_, class Reparse_>
+    static void parse_chunk_with_batch_checks(Parse_ parse, Validate_ validate, Reparse_ reparse) {
+        std::exception_ptr error;
+        try {
+            parse();
+            if (validate()) {
+                return;
             }
-            if (!chomp(input)) {
-                throw std::runtime_error("expected at least three fields for a coordinate matrix on line " + std::to_string(overall_line_count + 1));
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        reparse();
+        if (error) {
+            std::rethrow_exception(error); // only reached if the re-parse did not throw, which should not be possible.
+        }
+    }
+
+    void check_num_lines_loop(LineIndex data_line_count) const {
+        if (data_line_count >= my_nlines) {
+            throw std::runtime_error("more lines present than specified in the header (" + std::to_string(data_line_count) + " versus " + std::to_string(my_nlines) + ")");
+        }
+    }
+
+    void check_num_lines_final(bool finished, LineIndex data_line_count) const {
+        if (finished) {
+            if (data_line_count != my_nlines) {
+                // Must be fewer, otherwise we would have triggered the error in check_num_lines_loop() during iteration.
+                throw std::runtime_error("fewer lines present than specified in the header (" + std::to_string(data_line_count) + " versus " + std::to_string(my_nlines) + ")");
             }
+        }
+    }
 
-            auto first_field = scan_index_field<false>(input, overall_line_count);
-            auto second_field = scan_index_field<false>(input, overall_line_count);
-            check_matrix_coordinate_line(first_field.index, second_field.index, overall_line_count);
+private:
+    static Index_ first_index(Index_ index) {
+        return index;
+    }
+
+    template<class Tuple_>
+    static Index_ first_index(const Tuple_& entry) {
+        return std::get<0>(entry);
+    }
+
+    // Branchless min/max reductions so that the compiler can vectorize the loop.
+    template<class Contents_>
+    bool check_matrix_coordinate_batch(const Contents_& contents) const {
+        if (contents.empty()) {
+            return true;
+        }
+        Index_ min_row = std::numeric_limits<Index_>::max(), max_row = 0;
+        Index_ min_col = std::numeric_limits<Index_>::max(), max_col = 0;
+        for (const auto& con : contents) {
+            const Index_ r = std::get<0>(con), c = std::get<1>(con);
+            min_row = std::min(min_row, r);
+            max_row = std::max(max_row, r);
+            min_col = std::min(min_col, c);
+            max_col = std::max(max_col, c);
+        }
+        return min_row > 0 && max_row <= my_nrows && min_col > 0 && max_col <= my_ncols;
+    }
+
+    template<class Input2_, class Line_>
+    void check_matrix_coordinate_line(Index_ currow, Index_ curcol, const Input2_& input, Line_ overall_line_count) const {
+        if (!currow) {
+            throw_parse_error(ParseErrorCode::INDEX_NOT_POSITIVE, "row index must be positive", input, overall_line_count);
+        }
+        if (currow > my_nrows) {
+            throw_parse_error(ParseErrorCode::INDEX_OUT_OF_RANGE, "row index out of range", input, overall_line_count);
+        }
+        if (!curcol) {
+            throw_parse_error(ParseErrorCode::INDEX_NOT_POSITIVE, "column index must be positive", input, overall_line_count);
+        }
+        if (curcol > my_ncols) {
+            throw_parse_error(ParseErrorCode::INDEX_OUT_OF_RANGE, "column index out of range", input, overall_line_count);
+        }
+    }
+
+    // Only for use in chunks that pass is_well_formed_chunk(), where each non-last field is followed by a single space and then another field.
+    // This uses the fast kernel where possible and otherwise falls back to the general parser, which is equivalent for such chunks.
+    template<class Input2_, class Line_>
+    static Index_ scan_well_formed_index_field(Input2_& input, Line_ overall_line_count) {
+        if constexpr(fast_line_kernel_available) {
+            std::size_t consumed = 0;
+            Index_ index;
+            if (parse_fast_field(input.data(), input.available(), consumed, ' ', index)) {
+                input.skip(consumed); // the input is still valid as the fast kernel never consumes the last bytes of the chunk.
+                return index;
+            }
+        }
+        return scan_index_field<false>(input, overall_line_count).index;
+    }
+
+    template<bool check_bounds_, bool well_formed_, typename Type_, class Input2_, typename FieldParser_, class WrappedStore_, class Line_>
+    bool scan_matrix_coordinate_non_pattern_base(Input2_& input, Line_& overall_line_count, FieldParser_& fparser, WrappedStore_ wstore) const {
+        bool valid = input.valid();
+        while (valid) {
+            if constexpr(fast_line_kernel_available && std::is_same<FieldParser_, IntegerFieldParser<Type_> >::value) {
+                Index_ row, col;
+                Type_ value;
+                const auto consumed = parse_fast_coordinate_line(input.data(), input.available(), row, col, value);
+                if (consumed) {
+                    if constexpr(check_bounds_) {
+                        check_matrix_coordinate_line(row, col, input, overall_line_count);
+                    }
+                    if (!wstore(row, col, value)) {
+                        return false;
+                    }
+                    ++overall_line_count;
+                    valid = input.skip(consumed);
+                    continue;
+                }
+            }
+
+            Index_ row, col;
+            if constexpr(well_formed_) {
+                row = scan_well_formed_index_field(input, overall_line_count);
+                col = scan_well_formed_index_field(input, overall_line_count);
+            } else {
+                // Handling stray comments, empty lines, and leading spaces.
+                if (!skip_lines(input, overall_line_count)) {
+                    break;
+                }
+                if (!chomp(input)) {
+                    throw_parse_error(ParseErrorCode::MISSING_FIELD, "expected at least three fields for a coordinate matrix", input, overall_line_count);
+                }
+                row = scan_index_field<false>(input, overall_line_count).index;
+                col = scan_index_field<false>(input, overall_line_count).index;
+            }
+            if constexpr(check_bounds_) {
+                check_matrix_coordinate_line(row, col, input, overall_line_count);
+            }
 
             // 'fparser' should leave 'input' at the start of the next line, if any exists.
             ParseInfo<Type_> res = fparser(input, overall_line_count);
-            if (!wstore(first_field.index, second_field.index, res.value)) {
+            if (!wstore(row, col, res.value)) {
                 return false;
             }
             ++overall_line_count;
@@ -917,44 +1681,81 @@ private:
 
     template<typename Type_, class FieldParser_, class Store_>
     bool scan_matrix_coordinate_non_pattern(Store_ store) {
+        return dispatch_line_tracking([&](auto line) -> bool {
+            return scan_matrix_coordinate_non_pattern<Type_, FieldParser_>(std::move(store), line);
+        });
+    }
+
+    template<typename Type_, class FieldParser_, class Store_, class Line_>
+    bool scan_matrix_coordinate_non_pattern(Store_ store, Line_ line) {
         bool finished = false;
         LineIndex current_data_line = 0;
+        const auto scan_start = start_scan();
 
         if (my_nthreads == 1) {
             FieldParser_ fparser;
-            finished = scan_matrix_coordinate_non_pattern_base<Type_>(
+            finished = scan_matrix_coordinate_non_pattern_base<true, false, Type_>(
                 my_input,
-                my_current_line,
+                serial_line(line),
                 fparser,
                 [&](Index_ r, Index_ c, Type_ value) -> bool {
                     check_num_lines_loop(current_data_line);
                     ++current_data_line;
-                    return store(r, c, value);
+                    if (!store(r, c, value)) {
+                        return false;
+                    }
+                    serial_progress(current_data_line); // only reporting lines that were successfully stored.
+                    return true;
                 }
             );
+            my_all_integral = fparser.all_integral();
 
         } else {
             struct Workspace {
-                std::vector<char> buffer;
+                Workspace(std::pmr::memory_resource* resource) : buffer(resource), contents(resource) {}
+                std::pmr::vector<char> buffer;
                 FieldParser_ fparser;
-                std::vector<std::tuple<Index_, Index_, Type_> > contents;
-                LineIndex overall_line;
+                std::pmr::vector<std::tuple<Index_, Index_, Type_> > contents;
+                Line_ overall_line;
             };
 
-            ThreadPool<Workspace> tp(
+            ThreadPool<Workspace, Stats_> tp(
                 [&](Workspace& work) -> bool {
-                    DirectBufferedReader bufreader(work.buffer.data(), work.buffer.size());
-                    return scan_matrix_coordinate_non_pattern_base<Type_>(
-                        bufreader,
-                        work.overall_line,
-                        work.fparser,
-                        [&](Index_ r, Index_ c, Type_ value) -> bool {
-                            work.contents.emplace_back(r, c, value);
-                            return true; // threads cannot quit early in their parallel sections; this (and thus scan_*_base) must always return true.
+                    const Line_ start_line = work.overall_line;
+                    parse_chunk_with_batch_checks(
+                        [&]() -> void {
+                            DirectBufferedReader bufreader(work.buffer.data(), work.buffer.size());
+                            auto wstore = [&](Index_ r, Index_ c, Type_ value) -> bool {
+                                work.contents.emplace_back(r, c, value);
+                                return true; // threads cannot quit early in their parallel sections; this (and thus scan_*_base) must always return true.
+                            };
+
+                            // Speculatively skipping the handling of comments and variable whitespace if the chunk doesn't need it.
+                            // Any errors are reported by the re-parse with the full grammar, so the behavior is the same either way.
+                            // Integer lines are already handled by the fast kernel, so the check would not pay for itself.
+                            constexpr bool speculate = !(fast_line_kernel_available && std::is_same<FieldParser_, IntegerFieldParser<Type_> >::value);
+                            if (speculate && is_well_formed_chunk(work.buffer)) {
+                                scan_matrix_coordinate_non_pattern_base<false, true, Type_>(bufreader, work.overall_line, work.fparser, wstore);
+                            } else {
+                                scan_matrix_coordinate_non_pattern_base<false, false, Type_>(bufreader, work.overall_line, work.fparser, wstore);
+                            }
+                        },
+                        [&]() -> bool {
+                            return check_matrix_coordinate_batch(work.contents);
+                        },
+                        [&]() -> void {
+                            DirectBufferedReader bufreader(work.buffer.data(), work.buffer.size());
+                            Line_ reline = start_line;
+                            scan_matrix_coordinate_non_pattern_base<true, false, Type_>(bufreader, reline, work.fparser, [](Index_, Index_, Type_) -> bool { return true; });
                         }
                     );
+                    return true;
                 },
-                my_nthreads
+                my_nthreads,
+                my_executor.get(),
+                my_max_inflight_bytes,
+                my_memory_resource,
+                &my_stats
             );
 
             finished = tp.run(
@@ -962,38 +1763,63 @@ private:
                     return configure_parallel_workspace(work);
                 },
                 [&](Workspace& work) -> bool {
-                    for (const auto& con : work.contents) {
-                        check_num_lines_loop(current_data_line); // defer check here for the correctly sync'd value of current_data_line.
+                    my_all_integral = my_all_integral && work.fparser.all_integral();
+                    const auto limit = check_num_lines_chunk(current_data_line, work.contents.size());
+                    for (std::size_t i = 0; i < limit; ++i) {
+                        const auto& con = work.contents[i];
+                        ++current_data_line;
                         if (!store(std::get<0>(con), std::get<1>(con), std::get<2>(con))) {
                             return false;
                         }
-                        ++current_data_line;
                     }
+                    if (limit < work.contents.size()) {
+                        check_num_lines_loop(current_data_line);
+                    }
+                    parallel_progress(current_data_line);
                     return true;
                 }
             );
         }
 
+        finish_scan(scan_start, finished, current_data_line);
         check_num_lines_final(finished, current_data_line);
         return finished;
     }
 
 private:
-    template<class Input2_, class WrappedStore_>
-    bool scan_matrix_coordinate_pattern_base(Input2_& input, LineIndex& overall_line_count, WrappedStore_ wstore) const {
+    template<bool check_bounds_, class Input2_, class WrappedStore_, class Line_>
+    bool scan_matrix_coordinate_pattern_base(Input2_& input, Line_& overall_line_count, WrappedStore_ wstore) const {
         bool valid = input.valid();
         while (valid) {
+            if constexpr(fast_line_kernel_available) {
+                Index_ row, col;
+                const auto consumed = parse_fast_coordinate_line(input.data(), input.available(), row, col);
+                if (consumed) {
+                    if constexpr(check_bounds_) {
+                        check_matrix_coordinate_line(row, col, input, overall_line_count);
+                    }
+                    if (!wstore(row, col)) {
+                        return false;
+                    }
+                    ++overall_line_count;
+                    valid = input.skip(consumed);
+                    continue;
+                }
+            }
+
             // Handling stray comments, empty lines, and leading spaces.
             if (!skip_lines(input, overall_line_count)) {
                 break;
             }
             if (!chomp(input)) {
-                throw std::runtime_error("expected two fields for a pattern matrix on line " + std::to_string(overall_line_count + 1));
+                throw_parse_error(ParseErrorCode::MISSING_FIELD, "expected two fields for a pattern matrix", input, overall_line_count);
             }
 
             auto first_field = scan_index_field<false>(input, overall_line_count);
             auto second_field = scan_index_field<true>(input, overall_line_count);
-            check_matrix_coordinate_line(first_field.index, second_field.index, overall_line_count);
+            if constexpr(check_bounds_) {
+                check_matrix_coordinate_line(first_field.index, second_field.index, input, overall_line_count);
+            }
 
             if (!wstore(first_field.index, second_field.index)) {
                 return false;
@@ -1007,40 +1833,71 @@ private:
 
     template<class Store_>
     bool scan_matrix_coordinate_pattern(Store_ store) {
+        return dispatch_line_tracking([&](auto line) -> bool {
+            return scan_matrix_coordinate_pattern(std::move(store), line);
+        });
+    }
+
+    template<class Store_, class Line_>
+    bool scan_matrix_coordinate_pattern(Store_ store, Line_ line) {
         bool finished = false;
         LineIndex current_data_line = 0;
+        const auto scan_start = start_scan();
 
         if (my_nthreads == 1) {
-            finished = scan_matrix_coordinate_pattern_base(
+            finished = scan_matrix_coordinate_pattern_base<true>(
                 my_input,
-                my_current_line,
+                serial_line(line),
                 [&](Index_ r, Index_ c) -> bool {
                     check_num_lines_loop(current_data_line);
                     ++current_data_line;
-                    return store(r, c);
+                    if (!store(r, c)) {
+                        return false;
+                    }
+                    serial_progress(current_data_line);
+                    return true;
                 }
             );
 
         } else {
             struct Workspace {
-                std::vector<char> buffer;
-                std::vector<std::tuple<Index_, Index_> > contents;
-                LineIndex overall_line;
+                Workspace(std::pmr::memory_resource* resource) : buffer(resource), contents(resource) {}
+                std::pmr::vector<char> buffer;
+                std::pmr::vector<std::tuple<Index_, Index_> > contents;
+                Line_ overall_line;
             };
 
-            ThreadPool<Workspace> tp(
+            ThreadPool<Workspace, Stats_> tp(
                 [&](Workspace& work) -> bool {
-                    DirectBufferedReader bufreader(work.buffer.data(), work.buffer.size());
-                    return scan_matrix_coordinate_pattern_base(
-                        bufreader,
-                        work.overall_line,
-                        [&](Index_ r, Index_ c) -> bool {
-                            work.contents.emplace_back(r, c);
-                            return true; // threads cannot quit early in their parallel sections; this (and thus scan_*_base) must always return true.
+                    const Line_ start_line = work.overall_line;
+                    parse_chunk_with_batch_checks(
+                        [&]() -> void {
+                            DirectBufferedReader bufreader(work.buffer.data(), work.buffer.size());
+                            scan_matrix_coordinate_pattern_base<false>(
+                                bufreader,
+                                work.overall_line,
+                                [&](Index_ r, Index_ c) -> bool {
+                                    work.contents.emplace_back(r, c);
+                                    return true; // threads cannot quit early in their parallel sections; this (and thus scan_*_base) must always return true.
+                                }
+                            );
+                        },
+                        [&]() -> bool {
+                            return check_matrix_coordinate_batch(work.contents);
+                        },
+                        [&]() -> void {
+                            DirectBufferedReader bufreader(work.buffer.data(), work.buffer.size());
+                            Line_ reline = start_line;
+                            scan_matrix_coordinate_pattern_base<true>(bufreader, reline, [](Index_, Index_) -> bool { return true; });
                         }
                     );
+                    return true;
                 },
-                my_nthreads
+                my_nthreads,
+                my_executor.get(),
+                my_max_inflight_bytes,
+                my_memory_resource,
+                &my_stats
             );
 
             finished = tp.run(
@@ -1048,50 +1905,77 @@ private:
                     return configure_parallel_workspace(work);
                 },
                 [&](Workspace& work) -> bool {
-                    for (const auto& con : work.contents) {
-                        check_num_lines_loop(current_data_line);
+                    const auto limit = check_num_lines_chunk(current_data_line, work.contents.size());
+                    for (std::size_t i = 0; i < limit; ++i) {
+                        const auto& con = work.contents[i];
+                        ++current_data_line;
                         if (!store(std::get<0>(con), std::get<1>(con))) {
                             return false;
                         }
-                        ++current_data_line;
                     }
+                    if (limit < work.contents.size()) {
+                        check_num_lines_loop(current_data_line);
+                    }
+                    parallel_progress(current_data_line);
                     return true;
                 }
             );
         }
 
+        finish_scan(scan_start, finished, current_data_line);
         check_num_lines_final(finished, current_data_line);
         return finished;
     }
 
 private:
-    void check_vector_coordinate_line(Index_ currow, LineIndex overall_line_count) const {
+    template<class Contents_>
+    bool check_vector_coordinate_batch(const Contents_& contents) const {
+        if (contents.empty()) {
+            return true;
+        }
+        Index_ min_row = std::numeric_limits<Index_>::max(), max_row = 0;
+        for (const auto& con : contents) {
+            const Index_ r = first_index(con);
+            min_row = std::min(min_row, r);
+            max_row = std::max(max_row, r);
+        }
+        return min_row > 0 && max_row <= my_nrows;
+    }
+
+    template<class Input2_, class Line_>
+    void check_vector_coordinate_line(Index_ currow, const Input2_& input, Line_ overall_line_count) const {
         if (!currow) {
-            throw std::runtime_error("row index must be positive on line " + std::to_string(overall_line_count + 1));
+            throw_parse_error(ParseErrorCode::INDEX_NOT_POSITIVE, "row index must be positive", input, overall_line_count);
         }
         if (currow > my_nrows) {
-            throw std::runtime_error("row index out of range on line " + std::to_string(overall_line_count + 1));
+            throw_parse_error(ParseErrorCode::INDEX_OUT_OF_RANGE, "row index out of range", input, overall_line_count);
         }
     }
 
-    template<typename Type_, class Input2_, class FieldParser_, class WrappedStore_>
-    bool scan_vector_coordinate_non_pattern_base(Input2_& input, LineIndex& overall_line_count, FieldParser_& fparser, WrappedStore_ wstore) const {
+    template<bool check_bounds_, bool well_formed_, typename Type_, class Input2_, class FieldParser_, class WrappedStore_, class Line_>
+    bool scan_vector_coordinate_non_pattern_base(Input2_& input, Line_& overall_line_count, FieldParser_& fparser, WrappedStore_ wstore) const {
         bool valid = input.valid();
         while (valid) {
-            // handling stray comments, empty lines, and leading spaces.
-            if (!skip_lines(input, overall_line_count)) {
-                break;
+            Index_ row;
+            if constexpr(well_formed_) {
+                row = scan_well_formed_index_field(input, overall_line_count);
+            } else {
+                // handling stray comments, empty lines, and leading spaces.
+                if (!skip_lines(input, overall_line_count)) {
+                    break;
+                }
+                if (!chomp(input)) {
+                    throw_parse_error(ParseErrorCode::MISSING_FIELD, "expected at least two fields for a coordinate vector", input, overall_line_count);
+                }
+                row = scan_index_field<false>(input, overall_line_count).index;
             }
-            if (!chomp(input)) {
-                throw std::runtime_error("expected at least two fields for a coordinate vector on line " + std::to_string(overall_line_count + 1));
+            if constexpr(check_bounds_) {
+                check_vector_coordinate_line(row, input, overall_line_count);
             }
 
-            auto first_field = scan_index_field<false>(input, overall_line_count);
-            check_vector_coordinate_line(first_field.index, overall_line_count);
-
             // 'fparser' should leave 'input' at the start of the next line, if any exists.
             ParseInfo<Type_> res = fparser(input, overall_line_count);
-            if (!wstore(first_field.index, res.value)) {
+            if (!wstore(row, res.value)) {
                 return false;
             }
             ++overall_line_count;
@@ -1103,44 +1987,78 @@ private:
 
     template<typename Type_, class FieldParser_, class Store_>
     bool scan_vector_coordinate_non_pattern(Store_ store) {
+        return dispatch_line_tracking([&](auto line) -> bool {
+            return scan_vector_coordinate_non_pattern<Type_, FieldParser_>(std::move(store), line);
+        });
+    }
+
+    template<typename Type_, class FieldParser_, class Store_, class Line_>
+    bool scan_vector_coordinate_non_pattern(Store_ store, Line_ line) {
         bool finished = false;
         LineIndex current_data_line = 0;
+        const auto scan_start = start_scan();
 
         if (my_nthreads == 1) {
             FieldParser_ fparser;
-            finished = scan_vector_coordinate_non_pattern_base<Type_>(
+            finished = scan_vector_coordinate_non_pattern_base<true, false, Type_>(
                 my_input,
-                my_current_line,
+                serial_line(line),
                 fparser,
                 [&](Index_ r, Type_ value) -> bool {
                     check_num_lines_loop(current_data_line);
                     ++current_data_line;
-                    return store(r, 1, value);
+                    if (!store(r, 1, value)) {
+                        return false;
+                    }
+                    serial_progress(current_data_line);
+                    return true;
                 }
             );
+            my_all_integral = fparser.all_integral();
 
         } else {
             struct Workspace {
-                std::vector<char> buffer;
+                Workspace(std::pmr::memory_resource* resource) : buffer(resource), contents(resource) {}
+                std::pmr::vector<char> buffer;
                 FieldParser_ fparser;
-                std::vector<std::tuple<Index_, Type_> > contents;
-                LineIndex overall_line;
+                std::pmr::vector<std::tuple<Index_, Type_> > contents;
+                Line_ overall_line;
             };
 
-            ThreadPool<Workspace> tp(
+            ThreadPool<Workspace, Stats_> tp(
                 [&](Workspace& work) -> bool {
-                    DirectBufferedReader bufreader(work.buffer.data(), work.buffer.size());
-                    return scan_vector_coordinate_non_pattern_base<Type_>(
-                        bufreader,
-                        work.overall_line,
-                        work.fparser,
-                        [&](Index_ r, Type_ value) -> bool {
-                            work.contents.emplace_back(r, value);
-                            return true; // threads cannot quit early in their parallel sections; this (and thus scan_*_base) must always return true.
+                    const Line_ start_line = work.overall_line;
+                    parse_chunk_with_batch_checks(
+                        [&]() -> void {
+                            DirectBufferedReader bufreader(work.buffer.data(), work.buffer.size());
+                            auto wstore = [&](Index_ r, Type_ value) -> bool {
+                                work.contents.emplace_back(r, value);
+                                return true; // threads cannot quit early in their parallel sections; this (and thus scan_*_base) must always return true.
+                            };
+
+                            // Speculatively skipping the handling of comments and variable whitespace, see scan_matrix_coordinate_non_pattern().
+                            if (is_well_formed_chunk(work.buffer)) {
+                                scan_vector_coordinate_non_pattern_base<false, true, Type_>(bufreader, work.overall_line, work.fparser, wstore);
+                            } else {
+                                scan_vector_coordinate_non_pattern_base<false, false, Type_>(bufreader, work.overall_line, work.fparser, wstore);
+                            }
+                        },
+                        [&]() -> bool {
+                            return check_vector_coordinate_batch(work.contents);
+                        },
+                        [&]() -> void {
+                            DirectBufferedReader bufreader(work.buffer.data(), work.buffer.size());
+                            Line_ reline = start_line;
+                            scan_vector_coordinate_non_pattern_base<true, false, Type_>(bufreader, reline, work.fparser, [](Index_, Type_) -> bool { return true; });
                         }
                     );
+                    return true;
                 },
-                my_nthreads
+                my_nthreads,
+                my_executor.get(),
+                my_max_inflight_bytes,
+                my_memory_resource,
+                &my_stats
             );
 
             finished = tp.run(
@@ -1148,37 +2066,48 @@ private:
                     return configure_parallel_workspace(work);
                 },
                 [&](Workspace& work) -> bool {
-                    for (const auto& con : work.contents) {
-                        check_num_lines_loop(current_data_line);
+                    my_all_integral = my_all_integral && work.fparser.all_integral();
+                    const auto limit = check_num_lines_chunk(current_data_line, work.contents.size());
+                    for (std::size_t i = 0; i < limit; ++i) {
+                        const auto& con = work.contents[i];
+                        ++current_data_line;
                         if (!store(std::get<0>(con), 1, std::get<1>(con))) {
                             return false;
                         }
-                        ++current_data_line;
                     }
+                    if (limit < work.contents.size()) {
+                        check_num_lines_loop(current_data_line);
+                    }
+                    parallel_progress(current_data_line);
                     return true;
                 }
             );
         }
 
+        finish_scan(scan_start, finished, current_data_line);
         check_num_lines_final(finished, current_data_line);
         return finished;
     }
 
 private:
-    template<class Input2_, class WrappedStore_>
-    bool scan_vector_coordinate_pattern_base(Input2_& input, LineIndex& overall_line_count, WrappedStore_ wstore) const {
+    template<bool check_bounds_, bool well_formed_, class Input2_, class WrappedStore_, class Line_>
+    bool scan_vector_coordinate_pattern_base(Input2_& input, Line_& overall_line_count, WrappedStore_ wstore) const {
         bool valid = input.valid();
         while (valid) {
-            // Handling stray comments, empty lines, and leading spaces.
-            if (!skip_lines(input, overall_line_count)) {
-                break;
-            }
-            if (!chomp(input)) {
-                throw std::runtime_error("expected one field for a coordinate vector on line " + std::to_string(overall_line_count + 1));
+            if constexpr(!well_formed_) {
+                // Handling stray comments, empty lines, and leading spaces.
+                if (!skip_lines(input, overall_line_count)) {
+                    break;
+                }
+                if (!chomp(input)) {
+                    throw_parse_error(ParseErrorCode::MISSING_FIELD, "expected one field for a coordinate vector", input, overall_line_count);
+                }
             }
 
             auto first_field = scan_index_field<true>(input, overall_line_count);
-            check_vector_coordinate_line(first_field.index, overall_line_count);
+            if constexpr(check_bounds_) {
+                check_vector_coordinate_line(first_field.index, input, overall_line_count);
+            }
 
             if (!wstore(first_field.index)) {
                 return false;
@@ -1192,40 +2121,74 @@ private:
 
     template<class Store_>
     bool scan_vector_coordinate_pattern(Store_ store) {
+        return dispatch_line_tracking([&](auto line) -> bool {
+            return scan_vector_coordinate_pattern(std::move(store), line);
+        });
+    }
+
+    template<class Store_, class Line_>
+    bool scan_vector_coordinate_pattern(Store_ store, Line_ line) {
         bool finished = false;
         LineIndex current_data_line = 0;
+        const auto scan_start = start_scan();
 
         if (my_nthreads == 1) {
-            finished = scan_vector_coordinate_pattern_base(
+            finished = scan_vector_coordinate_pattern_base<true, false>(
                 my_input,
-                my_current_line,
+                serial_line(line),
                 [&](Index_ r) -> bool {
                     check_num_lines_loop(current_data_line);
                     ++current_data_line;
-                    return store(r, 1);
+                    if (!store(r, 1)) {
+                        return false;
+                    }
+                    serial_progress(current_data_line);
+                    return true;
                 }
             );
 
         } else {
             struct Workspace {
-                std::vector<char> buffer;
-                std::vector<Index_> contents;
-                LineIndex overall_line;
+                Workspace(std::pmr::memory_resource* resource) : buffer(resource), contents(resource) {}
+                std::pmr::vector<char> buffer;
+                std::pmr::vector<Index_> contents;
+                Line_ overall_line;
             };
 
-            ThreadPool<Workspace> tp(
+            ThreadPool<Workspace, Stats_> tp(
                 [&](Workspace& work) -> bool {
-                    DirectBufferedReader bufreader(work.buffer.data(), work.buffer.size());
-                    return scan_vector_coordinate_pattern_base(
-                        bufreader,
-                        work.overall_line,
-                        [&](Index_ r) -> bool {
-                            work.contents.emplace_back(r);
-                            return true; // threads cannot quit early in their parallel sections; this (and thus scan_*_base) must always return true.
+                    const Line_ start_line = work.overall_line;
+                    parse_chunk_with_batch_checks(
+                        [&]() -> void {
+                            DirectBufferedReader bufreader(work.buffer.data(), work.buffer.size());
+                            auto wstore = [&](Index_ r) -> bool {
+                                work.contents.emplace_back(r);
+                                return true; // threads cannot quit early in their parallel sections; this (and thus scan_*_base) must always return true.
+                            };
+
+                            // Speculatively skipping the handling of comments and variable whitespace, see scan_matrix_coordinate_non_pattern().
+                            if (is_well_formed_chunk(work.buffer)) {
+                                scan_vector_coordinate_pattern_base<false, true>(bufreader, work.overall_line, wstore);
+                            } else {
+                                scan_vector_coordinate_pattern_base<false, false>(bufreader, work.overall_line, wstore);
+                            }
+                        },
+                        [&]() -> bool {
+                            return check_vector_coordinate_batch(work.contents);
+                        },
+                        [&]() -> void {
+                            DirectBufferedReader bufreader(work.buffer.data(), work.buffer.size());
+                            Line_ reline = start_line;
+                            scan_vector_coordinate_pattern_base<true, false>(bufreader, reline, [](Index_) -> bool { return true; });
                         }
                     );
+                    return true;
                 },
-                my_nthreads
+                my_nthreads,
+                my_executor.get(),
+                my_max_inflight_bytes,
+                my_memory_resource,
+                &my_stats
             );
 
             finished = tp.run(
@@ -1233,33 +2196,41 @@ private:
                     return configure_parallel_workspace(work);
                 },
                 [&](Workspace& work) -> bool {
-                    for (const auto& r : work.contents) {
-                        check_num_lines_loop(current_data_line);
+                    const auto limit = check_num_lines_chunk(current_data_line, work.contents.size());
+                    for (std::size_t i = 0; i < limit; ++i) {
+                        const auto& r = work.contents[i];
+                        ++current_data_line;
                         if (!store(r, 1)) {
                             return false;
                         }
-                        ++current_data_line;
                     }
+                    if (limit < work.contents.size()) {
+                        check_num_lines_loop(current_data_line);
+                    }
+                    parallel_progress(current_data_line);
                     return true;
                 }
             );
         }
 
+        finish_scan(scan_start, finished, current_data_line);
         check_num_lines_final(finished, current_data_line);
         return finished;
     }
 
 private:
-    template<typename Type_, class Input2_, class FieldParser_, class WrappedStore_>
-    bool scan_matrix_array_base(Input2_& input, LineIndex& overall_line_count, FieldParser_& fparser, WrappedStore_ wstore) const {
+    template<bool well_formed_, typename Type_, class Input2_, class FieldParser_, class WrappedStore_, class Line_>
+    bool scan_matrix_array_base(Input2_& input, Line_& overall_line_count, FieldParser_& fparser, WrappedStore_ wstore) const {
         bool valid = input.valid();
         while (valid) {
-            // Handling stray comments, empty lines, and leading spaces.
-            if (!skip_lines(input, overall_line_count)) {
-                break;
-            }
-            if (!chomp(input)) {
-                throw std::runtime_error("expected at least one field for an array matrix on line " + std::to_string(overall_line_count + 1));
+            if constexpr(!well_formed_) {
+                // Handling stray comments, empty lines, and leading spaces.
+                if (!skip_lines(input, overall_line_count)) {
+                    break;
+                }
+                if (!chomp(input)) {
+                    throw_parse_error(ParseErrorCode::MISSING_FIELD, "expected at least one field for an array matrix", input, overall_line_count);
+                }
             }
 
             // 'fparser' should leave 'input' at the start of the next line, if any exists.
@@ -1276,8 +2247,16 @@ private:
 
     template<typename Type_, class FieldParser_, class Store_>
     bool scan_matrix_array(Store_ store) {
+        return dispatch_line_tracking([&](auto line) -> bool {
+            return scan_matrix_array<Type_, FieldParser_>(std::move(store), line);
+        });
+    }
+
+    template<typename Type_, class FieldParser_, class Store_, class Line_>
+    bool scan_matrix_array(Store_ store, Line_ line) {
         bool finished = false;
         LineIndex current_data_line = 0;
+        const auto scan_start = start_scan();
 
         Index_ currow = 1, curcol = 1;
         auto increment = [&]() {
@@ -1290,43 +2269,53 @@ private:
 
         if (my_nthreads == 1) {
             FieldParser_ fparser;
-            finished = scan_matrix_array_base<Type_>(
+            finished = scan_matrix_array_base<false, Type_>(
                 my_input,
-                my_current_line,
+                serial_line(line),
                 fparser,
                 [&](Type_ value) -> bool {
                     check_num_lines_loop(current_data_line);
+                    ++current_data_line;
                     if (!store(currow, curcol, value)) {
                         return false;
                     }
-                    ++current_data_line;
+                    serial_progress(current_data_line);
                     increment();
                     return true;
                 }
             );
+            my_all_integral = fparser.all_integral();
 
         } else {
             struct Workspace {
-                std::vector<char> buffer;
+                Workspace(std::pmr::memory_resource* resource) : buffer(resource), contents(resource) {}
+                std::pmr::vector<char> buffer;
                 FieldParser_ fparser;
-                std::vector<Type_> contents;
-                LineIndex overall_line;
+                std::pmr::vector<Type_> contents;
+                Line_ overall_line;
             };
 
-            ThreadPool<Workspace> tp(
+            ThreadPool<Workspace, Stats_> tp(
                 [&](Workspace& work) -> bool {
                     DirectBufferedReader bufreader(work.buffer.data(), work.buffer.size());
-                    return scan_matrix_array_base<Type_>(
-                        bufreader,
-                        work.overall_line,
-                        work.fparser,
-                        [&](Type_ value) -> bool {
-                            work.contents.emplace_back(value);
-                            return true; // threads cannot quit early in their parallel sections; this (and thus scan_*_base) must always return true.
-                        }
-                    );
+                    auto wstore = [&](Type_ value) -> bool {
+                        work.contents.emplace_back(value);
+                        return true; // threads cannot quit early in their parallel sections; this (and thus scan_*_base) must always return true.
+                    };
+
+                    // Speculatively skipping the handling of comments and variable whitespace, see scan_matrix_coordinate_non_pattern().
+                    // skip_lines() and chomp() are no-ops at the start of each line of a well-formed chunk, so no re-parse is needed to report errors.
+                    if (is_well_formed_chunk(work.buffer)) {
+                        return scan_matrix_array_base<true, Type_>(bufreader, work.overall_line, work.fparser, wstore);
+                    } else {
+                        return scan_matrix_array_base<false, Type_>(bufreader, work.overall_line, work.fparser, wstore);
+                    }
                 },
-                my_nthreads
+                my_nthreads,
+                my_executor.get(),
+                my_max_inflight_bytes,
+                my_memory_resource,
+                &my_stats
             );
 
             finished = tp.run(
@@ -1334,34 +2323,43 @@ private:
                     return configure_parallel_workspace(work);
                 },
                 [&](Workspace& work) -> bool {
-                    for (const auto& val : work.contents) {
-                        check_num_lines_loop(current_data_line);
+                    my_all_integral = my_all_integral && work.fparser.all_integral();
+                    const auto limit = check_num_lines_chunk(current_data_line, work.contents.size());
+                    for (std::size_t i = 0; i < limit; ++i) {
+                        const auto& val = work.contents[i];
+                        ++current_data_line;
                         if (!store(currow, curcol, val)) {
                             return false;
                         }
-                        ++current_data_line;
                         increment();
                     }
+                    if (limit < work.contents.size()) {
+                        check_num_lines_loop(current_data_line);
+                    }
+                    parallel_progress(current_data_line);
                     return true;
                 }
             );
         }
 
+        finish_scan(scan_start, finished, current_data_line);
         check_num_lines_final(finished, current_data_line);
         return finished;
     }
 
 private:
-    template<typename Type_, class Input2_, class FieldParser_, class WrappedStore_>
-    bool scan_vector_array_base(Input2_& input, LineIndex& overall_line_count, FieldParser_& fparser, WrappedStore_ wstore) const {
+    template<bool well_formed_, typename Type_, class Input2_, class FieldParser_, class WrappedStore_, class Line_>
+    bool scan_vector_array_base(Input2_& input, Line_& overall_line_count, FieldParser_& fparser, WrappedStore_ wstore) const {
         bool valid = input.valid();
         while (valid) {
-            // Handling stray comments, empty lines, and leading spaces.
-            if (!skip_lines(input, overall_line_count)) {
-                break;
-            }
-            if (!chomp(input)) {
-                throw std::runtime_error("expected at least one field for an array vector on line " + std::to_string(overall_line_count + 1));
+            if constexpr(!well_formed_) {
+                // Handling stray comments, empty lines, and leading spaces.
+                if (!skip_lines(input, overall_line_count)) {
+                    break;
+                }
+                if (!chomp(input)) {
+                    throw_parse_error(ParseErrorCode::MISSING_FIELD, "expected at least one field for an array vector", input, overall_line_count);
+                }
             }
 
             // 'fparser' should leave 'input' at the start of the next line, if any exists.
@@ -1378,43 +2376,64 @@ private:
 
     template<typename Type_, class FieldParser_, class Store_>
     bool scan_vector_array(Store_ store) {
+        return dispatch_line_tracking([&](auto line) -> bool {
+            return scan_vector_array<Type_, FieldParser_>(std::move(store), line);
+        });
+    }
+
+    template<typename Type_, class FieldParser_, class Store_, class Line_>
+    bool scan_vector_array(Store_ store, Line_ line) {
         bool finished = false;
         LineIndex current_data_line = 0;
+        const auto scan_start = start_scan();
         if (my_nthreads == 1) {
             FieldParser_ fparser;
-            finished = scan_vector_array_base<Type_>(
+            finished = scan_vector_array_base<false, Type_>(
                 my_input,
-                my_current_line,
+                serial_line(line),
                 fparser,
                 [&](Type_ value) -> bool {
                     check_num_lines_loop(current_data_line);
                     ++current_data_line;
-                    return store(current_data_line, 1, value);
+                    if (!store(current_data_line, 1, value)) {
+                        return false;
+                    }
+                    serial_progress(current_data_line);
+                    return true;
                 }
             );
+            my_all_integral = fparser.all_integral();
 
         } else {
             struct Workspace {
-                std::vector<char> buffer;
+                Workspace(std::pmr::memory_resource* resource) : buffer(resource), contents(resource) {}
+                std::pmr::vector<char> buffer;
                 FieldParser_ fparser;
-                std::vector<Type_> contents;
-                LineIndex overall_line;
+                std::pmr::vector<Type_> contents;
+                Line_ overall_line;
             };
 
-            ThreadPool<Workspace> tp(
+            ThreadPool<Workspace, Stats_> tp(
                 [&](Workspace& work) -> bool {
                     DirectBufferedReader bufreader(work.buffer.data(), work.buffer.size());
-                    return scan_vector_array_base<Type_>(
-                        bufreader,
-                        work.overall_line,
-                        work.fparser,
-                        [&](Type_ value) -> bool {
-                            work.contents.emplace_back(value);
-                            return true; // threads cannot quit early in their parallel sections; this (and thus scan_*_base) must always return true.
-                        }
-                    );
+                    auto wstore = [&](Type_ value) -> bool {
+                        work.contents.emplace_back(value);
+                        return true; // threads cannot quit early in their parallel sections; this (and thus scan_*_base) must always return true.
+                    };
+
+                    // Speculatively skipping the handling of comments and variable whitespace, see scan_matrix_coordinate_non_pattern().
+                    // skip_lines() and chomp() are no-ops at the start of each line of a well-formed chunk, so no re-parse is needed to report errors.
+                    if (is_well_formed_chunk(work.buffer)) {
+                        return scan_vector_array_base<true, Type_>(bufreader, work.overall_line, work.fparser, wstore);
+                    } else {
+                        return scan_vector_array_base<false, Type_>(bufreader, work.overall_line, work.fparser, wstore);
+                    }
                 },
-                my_nthreads
+                my_nthreads,
+                my_executor.get(),
+                my_max_inflight_bytes,
+                my_memory_resource,
+                &my_stats
             );
 
             finished = tp.run(
@@ -1422,18 +2441,25 @@ private:
                     return configure_parallel_workspace(work);
                 },
                 [&](Workspace& work) -> bool {
-                    for (const auto& val : work.contents) {
-                        check_num_lines_loop(current_data_line);
+                    my_all_integral = my_all_integral && work.fparser.all_integral();
+                    const auto limit = check_num_lines_chunk(current_data_line, work.contents.size());
+                    for (std::size_t i = 0; i < limit; ++i) {
+                        const auto& val = work.contents[i];
                         ++current_data_line;
                         if (!store(current_data_line, 1, val)) {
                             return false;
                         }
                     }
+                    if (limit < work.contents.size()) {
+                        check_num_lines_loop(current_data_line);
+                    }
+                    parallel_progress(current_data_line);
                     return true;
                 }
             );
         }
 
+        finish_scan(scan_start, finished, current_data_line);
         check_num_lines_final(finished, current_data_line);
         return finished;
     }
@@ -1445,16 +2471,17 @@ private:
         }
     }
 
+private:
     template<typename Type_>
     class IntegerFieldParser {
     public:
-        template<class Input2_>
-        ParseInfo<Type_> operator()(Input2_& input, LineIndex overall_line_count) {
+        template<class Input2_, class Line_>
+        ParseInfo<Type_> operator()(Input2_& input, Line_ overall_line_count) {
             char firstchar = input.get();
             bool negative = (firstchar == '-');
             if (negative || firstchar == '+') {
                 if (!(input.advance())) {
-                    throw std::runtime_error("premature termination of an integer on line " + std::to_string(overall_line_count + 1));
+                    throw_parse_error(ParseErrorCode::INVALID_VALUE, "premature termination of an integer", input, overall_line_count);
                 }
             }
 
@@ -1477,13 +2504,13 @@ private:
                             if (negative) {
                                 // Structuring the conditionals so that it's most likely to short-circuit after only testing the first one.
                                 if (val <= lower_limit_before_mult && !(val == lower_limit_before_mult && delta <= lower_limit_mod)) {
-                                    throw std::runtime_error("integer underflow on line " + std::to_string(overall_line_count + 1));
+                                    throw_parse_error(ParseErrorCode::VALUE_OVERFLOW, "integer underflow", input, overall_line_count);
                                 }
                                 val *= 10;
                                 val -= delta;
                             } else {
                                 if (val >= upper_limit_before_mult && !(val == upper_limit_before_mult && delta <= upper_limit_mod)) {
-                                    throw std::runtime_error("integer overflow on line " + std::to_string(overall_line_count + 1));
+                                    throw_parse_error(ParseErrorCode::VALUE_OVERFLOW, "integer overflow", input, overall_line_count);
                                 }
                                 val *= 10;
                                 val += delta;
@@ -1496,7 +2523,7 @@ private:
                             return ParseInfo<Type_>(val, false);
                         }
                         if (input.get() != '\n') {
-                            throw std::runtime_error("more fields than expected on line " + std::to_string(overall_line_count + 1));
+                            throw_parse_error(ParseErrorCode::EXTRA_FIELD, "more fields than expected", input, overall_line_count);
                         }
                         return ParseInfo<Type_>(val, input.advance()); // move past the newline.
                     case '\n':
@@ -1506,11 +2533,11 @@ private:
                         // - a non-newline non-digit, in case we throw.
                         // - a newline, in which case we arrive here.
                         if (!found) {
-                            throw std::runtime_error("empty integer field on line " + std::to_string(overall_line_count + 1));
+                            throw_parse_error(ParseErrorCode::EMPTY_FIELD, "empty integer field", input, overall_line_count);
                         }
                         return ParseInfo<Type_>(val, input.advance()); // move past the newline.
                     default:
-                        throw std::runtime_error("expected an integer value on line " + std::to_string(overall_line_count + 1));
+                        throw_parse_error(ParseErrorCode::INVALID_VALUE, "expected an integer value", input, overall_line_count);
                 }
 
                 if (!(input.advance())) {
@@ -1520,6 +2547,10 @@ private:
 
             return ParseInfo<Type_>(val, false);
         }
+
+        bool all_integral() const {
+            return true;
+        }
     };
 
 public:
@@ -1566,10 +2597,12 @@ public:
     }
 
 private:
-    template<bool last_, typename Type_, typename Input2_>
-    static ParseInfo<Type_> parse_real(Input2_& input, std::string& temporary, Index overall_line_count) {
+    // 'all_integral' is set to false if the token is not an integer, and is otherwise left unchanged.
+    template<bool last_, typename Type_, typename Input2_, class Line_>
+    static ParseInfo<Type_> parse_real(Input2_& input, std::string& temporary, bool& all_integral, Line_ overall_line_count) {
         temporary.clear();
-        ParseInfo<Type_> output(0, true);
+        ParseInfo<Type_> output;
+        output.remaining = true;
 
         while (1) {
             char x = input.get();
@@ -1580,11 +2613,11 @@ private:
                         // it can be assumed that this function is only called after chomping to the next non-blank,
                         // so if it's not a newline, it'll be handled by the default case, and subsequently temporary will be non-empty.
                         if (temporary.empty()) {
-                            throw std::runtime_error("empty number field on line " + std::to_string(overall_line_count + 1));
+                            throw_parse_error(ParseErrorCode::EMPTY_FIELD, "empty number field", input, overall_line_count);
                         }
                         output.remaining = input.advance(); // move past the newline.
                     } else {
-                        throw std::runtime_error("unexpected newline on line " + std::to_string(overall_line_count + 1));
+                        throw_parse_error(ParseErrorCode::MISSING_FIELD, "unexpected newline", input, overall_line_count);
                     }
                     goto final_processing;
 
@@ -1594,16 +2627,16 @@ private:
                             output.remaining = false;
                         } else {
                             if (input.get() != '\n') {
-                                throw std::runtime_error("more fields than expected on line " + std::to_string(overall_line_count + 1));
+                                throw_parse_error(ParseErrorCode::EXTRA_FIELD, "more fields than expected", input, overall_line_count);
                             }
                             output.remaining = input.advance(); // move past the newline.
                         }
                     } else {
                         if (!advance_and_chomp(input)) { // skipping past the current position before chomping.
-                            throw std::runtime_error("unexpected end of file on line " + std::to_string(overall_line_count + 1));
+                            throw_parse_error(ParseErrorCode::MISSING_FIELD, "unexpected end of file", input, overall_line_count);
                         }
                         if (input.get() == '\n') {
-                            throw std::runtime_error("unexpected newline on line " + std::to_string(overall_line_count + 1));
+                            throw_parse_error(ParseErrorCode::MISSING_FIELD, "unexpected newline", input, overall_line_count);
                         }
                     }
                     goto final_processing;
@@ -1618,43 +2651,237 @@ private:
                     output.remaining = false;
                     goto final_processing;
                 }
-                throw std::runtime_error("unexpected end of file on line " + std::to_string(overall_line_count + 1));
+                throw_parse_error(ParseErrorCode::MISSING_FIELD, "unexpected end of file", input, overall_line_count);
             }
         }
 
 final_processing:
         if (temporary.size() >= 2 && temporary[0] == '0' && (temporary[1] == 'x' || temporary[1] == 'X')) {
-            throw std::runtime_error("hexadecimal numbers are not allowed on line " + std::to_string(overall_line_count + 1));
+            throw_parse_error(ParseErrorCode::INVALID_VALUE, "hexadecimal numbers are not allowed", input, overall_line_count);
+        }
+
+        typedef typename std::conditional<is_half_float<Type_>::value, double, Type_>::type Parsed;
+        Parsed parsed;
+        const auto integral = convert_integral_real(temporary.data(), temporary.size(), parsed);
+        all_integral = all_integral && integral != NOT_INTEGRAL;
+        if (integral != CONVERTED_INTEGRAL) {
+            parsed = convert_real<Parsed>(temporary, input, overall_line_count);
+        }
+
+        if constexpr(is_half_float<Type_>::value) {
+            output.value = round_half_float<Type_>(parsed, temporary, integral == CONVERTED_INTEGRAL);
+        } else {
+            output.value = parsed;
+        }
+        return output;
+    }
+
+    // Rounds the parsed double to a 16-bit type, which is the same as rounding the exact value of the token unless the double lies exactly on a midpoint between two 16-bit values.
+    // In that case, the token may be slightly above or below the midpoint, so we re-parse it with directed rounding to find out which side it is on.
+    template<typename Type_>
+    static Type_ round_half_float(double parsed, const std::string& temporary, bool exact) {
+        if (!exact && parsed != 0 && std::isfinite(parsed)) {
+            const Type_ below(std::nextafter(parsed, -std::numeric_limits<double>::infinity()));
+            const Type_ above(std::nextafter(parsed, std::numeric_limits<double>::infinity()));
+            if (below.bits != above.bits) {
+                const int mode = std::fegetround();
+                std::fesetround(FE_DOWNWARD);
+                const double lower = std::strtod(temporary.c_str(), NULL);
+                std::fesetround(FE_UPWARD);
+                const double upper = std::strtod(temporary.c_str(), NULL);
+                std::fesetround(mode);
+                if (lower != upper) {
+                    return (parsed == lower ? above : below);
+                }
+            }
+        }
+        return Type_(parsed);
+    }
+
+    enum IntegralToken : unsigned char { NOT_INTEGRAL, UNCONVERTED_INTEGRAL, CONVERTED_INTEGRAL };
+
+    // Many real-valued files only contain integers (e.g., counts), so we check for tokens that are just digits with an optional sign.
+    // If there are no more than 15 digits, the integer is exactly representable in a uint64 and is converted to 'Type_' with a single rounding step,
+    // giving the same result as std::stod() (or friends) without its overhead.
+    template<typename Type_>
+    static IntegralToken convert_integral_real(const char* temporary, std::size_t n, Type_& output) {
+        std::size_t i = 0;
+        bool negative = false;
+        if (n && (temporary[0] == '-' || temporary[0] == '+')) {
+            negative = (temporary[0] == '-');
+            ++i;
+        }
+        if (i == n) {
+            return NOT_INTEGRAL;
+        }
+
+        const std::size_t ndigits = n - i;
+        std::uint64_t value = 0;
+        for (; i < n; ++i) {
+            const unsigned char delta = temporary[i] - '0';
+            if (delta > 9) {
+                return NOT_INTEGRAL;
+            }
+            value = value * 10 + delta; // unsigned overflow is well-defined, and we won't use the value in such cases anyway.
+        }
+
+        if (ndigits > 15) {
+            return UNCONVERTED_INTEGRAL;
         }
+        output = static_cast<Type_>(value);
+        if (negative) {
+            output = -output; // negating after conversion so that "-0" gives a negative zero.
+        }
+        return CONVERTED_INTEGRAL;
+    }
+
+#if defined(__cpp_lib_to_chars)
+    // Returns std::errc::invalid_argument if the token is not entirely consumed.
+    template<typename Type_>
+    static std::errc convert_real_from_chars(const char* start, std::size_t n, Type_& value) {
+        // from_chars() does not accept a leading '+', so we skip it ourselves (but not if it's followed by another sign).
+        const char* end = start + n;
+        if (start != end && *start == '+' && (start + 1 == end || (start[1] != '-' && start[1] != '+'))) {
+            ++start;
+        }
+        auto res = std::from_chars(start, end, value);
+        if (res.ec == std::errc() && res.ptr != end) {
+            return std::errc::invalid_argument;
+        }
+        return res.ec;
+    }
+#endif
+
+    template<typename Type_, typename Input2_, class Line_>
+    static Type_ convert_real(const std::string& temporary, const Input2_& input, Line_ overall_line_count) {
+#if defined(__cpp_lib_to_chars)
+        if constexpr(std::is_same<Type_, float>::value || std::is_same<Type_, double>::value) {
+            // Parsing directly with from_chars(), which is correctly rounded and much faster than std::stof() or std::stod().
+            // Anything that it does not accept (e.g., out-of-range values, hexadecimal floats after a sign) falls through to the std::sto*() functions,
+            // so that these are handled in the same manner as before.
+            Type_ value;
+            if (convert_real_from_chars(temporary.data(), temporary.size(), value) == std::errc()) {
+                if constexpr(std::is_same<Type_, float>::value) {
+                    return value;
+                } else if (std::isnormal(value)) {
+                    return value; // std::stod() throws on subnormal values, and we leave the special values to it as well.
+                }
+            }
+        }
+#endif
 
         std::size_t n = 0;
+        Type_ value = 0;
         try {
             if constexpr(std::is_same<Type_, float>::value) {
-                output.value = std::stof(temporary, &n);
+                value = std::stof(temporary, &n);
             } else if constexpr(std::is_same<Type_, long double>::value) {
-                output.value = std::stold(temporary, &n);
+                value = std::stold(temporary, &n);
             } else {
-                output.value = std::stod(temporary, &n);
+                value = std::stod(temporary, &n);
             }
         } catch (std::invalid_argument& e) {
-            throw std::runtime_error("failed to convert value to a real number on line " + std::to_string(overall_line_count + 1));
+            throw_parse_error(ParseErrorCode::INVALID_VALUE, "failed to convert value to a real number", input, overall_line_count);
         }
 
         if (n != temporary.size()) {
-            throw std::runtime_error("failed to convert value to a real number on line " + std::to_string(overall_line_count + 1));
+            throw_parse_error(ParseErrorCode::INVALID_VALUE, "failed to convert value to a real number", input, overall_line_count);
         }
-        return output;
+        return value;
+    }
+
+    // Converts a token in place, without copying it into a std::string.
+    // This returns false for anything that might not give the same result as convert_real(), in which case the caller should use parse_real() instead.
+    template<typename Type_>
+    static bool convert_real_in_place(const char* token, std::size_t n, Type_& value, bool& integral) {
+        if (n >= 2 && token[0] == '0' && (token[1] == 'x' || token[1] == 'X')) {
+            return false; // leave it to parse_real() to report the error.
+        }
+
+        const auto status = convert_integral_real(token, n, value);
+        integral = (status != NOT_INTEGRAL);
+        if (status == CONVERTED_INTEGRAL) {
+            return true;
+        }
+
+#if defined(__cpp_lib_to_chars)
+        if constexpr(std::is_same<Type_, float>::value || std::is_same<Type_, double>::value) {
+            if (convert_real_from_chars(token, n, value) != std::errc()) {
+                return false;
+            }
+            if constexpr(std::is_same<Type_, double>::value) {
+                // std::stod() throws on subnormal values, and we leave special values to it as well.
+                return std::isnormal(value);
+            } else {
+                return true;
+            }
+        }
+#endif
+
+        return false;
+    }
+
+    // Parses a line that consists of two real fields (e.g., the real and imaginary parts of a complex value) from a contiguous block of bytes.
+    // Both fields are converted in place and written directly to 'first' and 'second', returning the number of bytes in the line (including the newline).
+    // Zero is returned if the line is not entirely contained in the block or needs any special handling, in which case the caller should use parse_real() on each field.
+    template<typename Type_>
+    static std::size_t parse_two_reals_in_place(const char* ptr, std::size_t available, Type_& first, Type_& second, bool& all_integral) {
+        auto is_blank = [](char x) -> bool {
+            return x == ' ' || x == '\t' || x == '\r';
+        };
+        auto find_token_end = [&](std::size_t position) -> std::size_t {
+            while (position < available && ptr[position] != '\n' && !is_blank(ptr[position])) {
+                ++position;
+            }
+            return position;
+        };
+        auto skip_blanks = [&](std::size_t position) -> std::size_t {
+            while (position < available && is_blank(ptr[position])) {
+                ++position;
+            }
+            return position;
+        };
+
+        const std::size_t first_end = find_token_end(0);
+        if (first_end == 0 || first_end == available || ptr[first_end] == '\n') {
+            return 0;
+        }
+        const std::size_t second_start = skip_blanks(first_end);
+        if (second_start == available || ptr[second_start] == '\n') {
+            return 0;
+        }
+        const std::size_t second_end = find_token_end(second_start);
+        const std::size_t newline = skip_blanks(second_end);
+        if (newline == available || ptr[newline] != '\n') {
+            return 0;
+        }
+
+        bool first_integral, second_integral;
+        if (
+            !convert_real_in_place(ptr, first_end, first, first_integral) ||
+            !convert_real_in_place(ptr + second_start, second_end - second_start, second, second_integral)
+        ) {
+            return 0;
+        }
+        all_integral = all_integral && first_integral && second_integral;
+        return newline + 1;
     }
 
     template<typename Type_>
     class RealFieldParser {
     public:
-        template<class Input2_>
-        ParseInfo<Type_> operator()(Input2_& input, LineIndex overall_line_count) {
-            return parse_real<true, Type_>(input, my_temporary, overall_line_count);
+        template<class Input2_, class Line_>
+        ParseInfo<Type_> operator()(Input2_& input, Line_ overall_line_count) {
+            return parse_real<true, Type_>(input, my_temporary, my_all_integral, overall_line_count);
+        }
+
+        bool all_integral() const {
+            return my_all_integral;
         }
+
     private:
         std::string my_temporary;
+        bool my_all_integral = true;
     };
 
 public:
@@ -1662,6 +2889,8 @@ public:
      * Scan the file for real lines, assuming that the field in the banner is `Field::REAL`.
      * 
      * @tparam Type_ Type to represent the real value.
+     * This may be a floating-point type, or one of the 16-bit storage types `Float16` and `BFloat16`.
+     * For the latter, each value is correctly rounded to the 16-bit type as it is parsed, avoiding a separate conversion pass over the parsed values.
      * @tparam Store_ Function to process each line.
      *
      * @param store Function with the signature `void(Index_ row, Index_ column, Type_ value)`,
@@ -1674,7 +2903,7 @@ public:
     template<typename Type_ = double, class Store_>
     bool scan_real(Store_&& store) {
         check_preamble();
-        static_assert(std::is_floating_point<Type_>::value);
+        static_assert(std::is_floating_point<Type_>::value || is_half_float<Type_>::value);
 
         auto store_real = [&](Index_ r, Index_ c, Type_ val) -> bool {
             if constexpr(std::is_same<typename std::invoke_result<Store_, Index_, Index_, Type_>::type, bool>::value) {
@@ -1723,18 +2952,36 @@ private:
     template<typename InnerType_>
     class ComplexFieldParser {
     public:
-        template<typename Input2_>
-        ParseInfo<std::complex<InnerType_> > operator()(Input2_& input, LineIndex overall_line_count) {
-            auto first = parse_real<false, InnerType_>(input, my_temporary, overall_line_count);
-            auto second = parse_real<true, InnerType_>(input, my_temporary, overall_line_count);
+        template<typename Input2_, class Line_>
+        ParseInfo<std::complex<InnerType_> > operator()(Input2_& input, Line_ overall_line_count) {
+            {
+                InnerType_ real, imag;
+                const auto consumed = parse_two_reals_in_place(input.data(), input.available(), real, imag, my_all_integral);
+                if (consumed) {
+                    ParseInfo<std::complex<InnerType_> > output;
+                    output.value.real(real);
+                    output.value.imag(imag);
+                    output.remaining = input.skip(consumed);
+                    return output;
+                }
+            }
+
+            auto first = parse_real<false, InnerType_>(input, my_temporary, my_all_integral, overall_line_count);
+            auto second = parse_real<true, InnerType_>(input, my_temporary, my_all_integral, overall_line_count);
             ParseInfo<std::complex<InnerType_> > output;
             output.value.real(first.value);
             output.value.imag(second.value);
             output.remaining = second.remaining;
             return output;
         }
+
+        bool all_integral() const {
+            return my_all_integral;
+        }
+
     private:
         std::string my_temporary;
+        bool my_all_integral = true;
     };
 
 public:
@@ -1781,6 +3028,35 @@ public:
         }
     }
 
+    /**
+     * Scan the file for complex lines, assuming that the field in the banner is `Field::COMPLEX`.
+     * This is equivalent to `scan_complex()` except that the real and imaginary parts are passed separately to `store`,
+     * which is convenient for callers that store them in separate arrays (i.e., structure-of-arrays) rather than as `std::complex` values.
+     * 
+     * @tparam Type_ Type to represent the real and imaginary parts of the complex value.
+     * @tparam Store_ Function to process each line.
+     *
+     * @param store Function with the signature `void(Index_ row, Index_ column, Type_ real, Type_ imaginary)`,
+     * which is passed the corresponding values at each line.
+     * Both `row` and `column` will be 1-based indices; for `Object::VECTOR`, `column` will be set to 1.
+     * Alternatively, this function may return `bool`, where a `false` indicates that the scanning should terminate early and a `true` indicates that the scanning should continue.
+     *
+     * @return Whether the scanning terminated early, based on `store` returning `false`. 
+     */
+    template<typename Type_ = double, class Store_>
+    bool scan_complex_split(Store_ store) {
+        // Both parts are parsed in place by ComplexFieldParser in a single pass over the line,
+        // and the intermediate std::complex is optimized away once the store is inlined.
+        return scan_complex<Type_>([&](Index_ r, Index_ c, std::complex<Type_> val) -> bool {
+            if constexpr(std::is_same<typename std::invoke_result<Store_, Index_, Index_, Type_, Type_>::type, bool>::value) {
+                return store(r, c, val.real(), val.imag());
+            } else {
+                store(r, c, val.real(), val.imag());
+                return true;
+            }
+        });
+    }
+
     /**
      * Scan the file for pattern lines, assuming that the field in the banner is `Field::PATTERN`.
      * This function only works when the format field is set to `Format::COORDINATE`.
@@ -1818,6 +3094,104 @@ public:
             return scan_vector_coordinate_pattern(std::move(store_pat));
         }
     }
+
+public:
+    /**
+     * Scan the file with a compile-time specification of the expected object, format and field.
+     * This checks that the banner matches the expected values, and then parses the file with a kernel that is specialized for the specified combination.
+     * It is equivalent to calling `scan_integer()`, `scan_real()`, `scan_complex()` or `scan_pattern()` as appropriate,
+     * but avoids instantiating the code for all other combinations of object and format.
+     * This may be more efficient for applications that only ever need to parse one type of file, e.g., integer coordinate matrices.
+     *
+     * @tparam object_ Expected object in the banner.
+     * @tparam format_ Expected format in the banner.
+     * @tparam field_ Expected field in the banner.
+     * `Field::REAL` and `Field::DOUBLE` are considered to be interchangeable.
+     * @tparam Type_ Type to represent each value.
+     * This should be an integer for `Field::INTEGER`, a floating-point type for `Field::REAL`, `Field::DOUBLE` and `Field::COMPLEX` (where it represents the real and imaginary parts),
+     * and is ignored for `Field::PATTERN`.
+     * `Float16` and `BFloat16` may also be used for `Field::REAL` and `Field::DOUBLE`, see `scan_real()`.
+     * @tparam Store_ Function to process each line.
+     *
+     * @param store Function with the signature `void(Index_ row, Index_ column, Value value)`, which is passed the corresponding values at each line.
+     * `Value` is `std::complex<Type_>` for `Field::COMPLEX`, `bool` for `Field::PATTERN` and `Type_` otherwise.
+     * Both `row` and `column` will be 1-based indices; for `Object::VECTOR`, `column` will be set to 1.
+     * Alternatively, this function may return `bool`, where a `false` indicates that the scanning should terminate early and a `true` indicates that the scanning should continue.
+     *
+     * @return Whether the scanning terminated early, based on `store` returning `false`. 
+     */
+    template<Object object_, Format format_, Field field_, typename Type_ = typename DefaultFieldType<field_>::type, class Store_>
+    bool scan_static(Store_ store) {
+        static_assert(field_ != Field::PATTERN || format_ == Format::COORDINATE, "'array' format for 'pattern' field is not supported");
+        check_preamble();
+
+        if (my_details.object != object_) {
+            throw std::runtime_error("object in the banner does not match the expected object");
+        }
+        if (my_details.format != format_) {
+            throw std::runtime_error("format in the banner does not match the expected format");
+        }
+        constexpr bool is_real = (field_ == Field::REAL || field_ == Field::DOUBLE);
+        if (is_real ? (my_details.field != Field::REAL && my_details.field != Field::DOUBLE) : (my_details.field != field_)) {
+            throw std::runtime_error("field in the banner does not match the expected field");
+        }
+
+        if constexpr(field_ == Field::PATTERN) {
+            auto store_pat = [&](Index_ r, Index_ c) -> bool {
+                if constexpr(std::is_same<typename std::invoke_result<Store_, Index_, Index_, bool>::type, bool>::value) {
+                    return store(r, c, true);
+                } else {
+                    store(r, c, true);
+                    return true;
+                }
+            };
+
+            if constexpr(object_ == Object::MATRIX) {
+                return scan_matrix_coordinate_pattern(std::move(store_pat));
+            } else {
+                return scan_vector_coordinate_pattern(std::move(store_pat));
+            }
+
+        } else {
+            if constexpr(field_ == Field::INTEGER) {
+                static_assert(std::is_integral<Type_>::value);
+            } else if constexpr(field_ == Field::COMPLEX) {
+                static_assert(std::is_floating_point<Type_>::value);
+            } else {
+                static_assert(std::is_floating_point<Type_>::value || is_half_float<Type_>::value);
+            }
+
+            typedef typename std::conditional<field_ == Field::COMPLEX, std::complex<Type_>, Type_>::type FullType;
+            typedef typename std::conditional<
+                field_ == Field::INTEGER,
+                IntegerFieldParser<Type_>,
+                typename std::conditional<field_ == Field::COMPLEX, ComplexFieldParser<Type_>, RealFieldParser<Type_> >::type
+            >::type FieldParser;
+
+            auto store_full = [&](Index_ r, Index_ c, FullType val) -> bool {
+                if constexpr(std::is_same<typename std::invoke_result<Store_, Index_, Index_, FullType>::type, bool>::value) {
+                    return store(r, c, val);
+                } else {
+                    store(r, c, val);
+                    return true;
+                }
+            };
+
+            if constexpr(format_ == Format::COORDINATE) {
+                if constexpr(object_ == Object::MATRIX) {
+                    return scan_matrix_coordinate_non_pattern<FullType, FieldParser>(std::move(store_full));
+                } else {
+                    return scan_vector_coordinate_non_pattern<FullType, FieldParser>(std::move(store_full));
+                }
+            } else {
+                if constexpr(object_ == Object::MATRIX) {
+                    return scan_matrix_array<FullType, FieldParser>(std::move(store_full));
+                } else {
+                    return scan_vector_array<FullType, FieldParser>(std::move(store_full));
+                }
+            }
+        }
+    }
 };
 
 }
@@ -0,0 +1,149 @@
+#ifndef EMINEM_PARSER_STATS_HPP
+#define EMINEM_PARSER_STATS_HPP
+
+#include <vector>
+#include <chrono>
+
+/**
+ * @file ParserStats.hpp
+ * @brief Statistics for profiling a `Parser`.
+ */
+
+namespace eminem {
+
+/**
+ * Phases of a scan that are reported to `ParserStats::start_phase()` and `ParserStats::end_phase()`.
+ */
+enum class ParserPhase : char {
+    /**
+     * The entire scan of the data lines, enclosing all other phases on the calling thread.
+     */
+    SCAN,
+
+    /**
+     * Extraction of bytes from the input, corresponding to `ParserStats::extract_seconds`.
+     * For `ParserOptions::num_threads = 1`, this is each call to `byteme::Reader::read()`.
+     * Otherwise, this is the filling of each chunk.
+     */
+    EXTRACT,
+
+    /**
+     * Counting of newlines in each chunk, corresponding to `ParserStats::count_newlines_seconds`.
+     */
+    COUNT_NEWLINES,
+
+    /**
+     * Parsing of each chunk by a worker, corresponding to `ParserStats::worker_parse_seconds`.
+     */
+    PARSE,
+
+    /**
+     * Passing the parsed values of each chunk to the `store` function, corresponding to `ParserStats::merge_seconds`.
+     */
+    MERGE
+};
+
+/**
+ * @brief Timings and throughput of the most recent scan.
+ *
+ * This is filled by `Parser::scan_integer()` (or related methods) when `ParserStats` is used as the `Stats_` template parameter of the `Parser`.
+ * It can be used to determine whether a scan is limited by I/O, parsing or the processing of parsed values in the `store` function.
+ * All times are wall-clock durations in seconds.
+ *
+ * Further statistics can be collected by using a subclass of `ParserStats` as the `Stats_` parameter.
+ * The subclass can redefine `start_phase()` and `end_phase()`, which are called by the `Parser` at the boundaries of each phase of the scan.
+ * For example, this can be used to read hardware performance counters for each phase.
+ */
+struct ParserStats {
+    /**
+     * Number of bytes consumed from the input during the scan.
+     * This does not include the preamble.
+     */
+    unsigned long long bytes_read = 0;
+
+    /**
+     * Number of data lines that were passed to the `store` function.
+     */
+    unsigned long long lines_parsed = 0;
+
+    /**
+     * Total time spent in the scan.
+     */
+    double total_seconds = 0;
+
+    /**
+     * Time spent by the main thread extracting bytes from the input.
+     * For `ParserOptions::num_threads = 1`, this is the time spent in `byteme::Reader::read()`, including any decompression.
+     * Otherwise, this is the time spent filling each chunk up to its terminating newline, which also includes the reads.
+     */
+    double extract_seconds = 0;
+
+    /**
+     * Time spent by the main thread counting the newlines in each chunk.
+     * This is only non-zero for `ParserOptions::num_threads > 1` and `ParserOptions::track_line_numbers = true`.
+     */
+    double count_newlines_seconds = 0;
+
+    /**
+     * Time spent by the main thread passing the parsed values of each chunk to the `store` function.
+     * This is only non-zero for `ParserOptions::num_threads > 1`, as the values are stored immediately after parsing in the serial case.
+     */
+    double merge_seconds = 0;
+
+    /**
+     * Time spent parsing chunks by each worker, i.e., each of the `ParserOptions::num_threads` jobs that can be in flight at any given time.
+     * This is empty for `ParserOptions::num_threads = 1`.
+     */
+    std::vector<double> worker_parse_seconds;
+
+    /**
+     * Time spent by each worker between the end of one chunk and the start of the next,
+     * i.e., waiting for its results to be merged, for a new chunk to be extracted, and for the executor to run the next job.
+     * This is empty for `ParserOptions::num_threads = 1`.
+     */
+    std::vector<double> worker_idle_seconds;
+
+    /**
+     * Called by the `Parser` at the start of each instance of a phase.
+     * The matching `end_phase()` is called once that instance is complete, unless an error is thrown.
+     * This does nothing by default.
+     *
+     * Calls for `ParserPhase::PARSE` are made on the threads of the `ParserOptions::executor` and may be concurrent.
+     * All other calls are made on the thread that called `Parser::scan_integer()` (or related methods).
+     * The `ParserStats` members are reset before the start of `ParserPhase::SCAN`, but any members of the subclass are left untouched.
+     *
+     * @param phase Phase that is starting.
+     */
+    void start_phase([[maybe_unused]] ParserPhase phase) {}
+
+    /**
+     * Called by the `Parser` at the end of each instance of a phase, see `start_phase()`.
+     * This does nothing by default.
+     *
+     * @param phase Phase that has ended.
+     */
+    void end_phase([[maybe_unused]] ParserPhase phase) {}
+};
+
+/**
+ * @brief Disable the collection of statistics.
+ *
+ * This is the default `Stats_` template parameter of the `Parser`, for which all bookkeeping is compiled away.
+ */
+struct NoStats {};
+
+/**
+ * @cond
+ */
+typedef std::chrono::steady_clock StatsClock;
+
+inline double seconds_since(StatsClock::time_point start) {
+    return std::chrono::duration<double>(StatsClock::now() - start).count();
+}
+/**
+ * @endcond
+ */
+
+}
+
+#endif
@@ -0,0 +1,132 @@
+#ifndef EMINEM_SINK_HPP
+#define EMINEM_SINK_HPP
+
+#include <vector>
+#include <string>
+#include <stdexcept>
+#include <cstdio>
+#include <cstddef>
+
+/**
+ * @file Sink.hpp
+ * @brief Destinations for the bytes of a Matrix Market file.
+ */
+
+namespace eminem {
+
+/**
+ * @brief Interface for a destination of bytes.
+ *
+ * This is the output counterpart to the `byteme::Reader`, to be used by the `Writer`.
+ * Applications may implement their own subclasses to write to other destinations, e.g., sockets or custom compressed streams.
+ */
+class Sink {
+public:
+    /**
+     * @cond
+     */
+    Sink() = default;
+    Sink(const Sink&) = delete;
+    Sink& operator=(const Sink&) = delete;
+    virtual ~Sink() = default;
+    /**
+     * @endcond
+     */
+
+    /**
+     * Write bytes to the destination.
+     * This will be called in order of the bytes in the file.
+     *
+     * @param buffer Pointer to an array of bytes.
+     * @param n Length of the array.
+     */
+    virtual void write(const unsigned char* buffer, std::size_t n) = 0;
+
+    /**
+     * Finish writing to the destination, e.g., by flushing any buffered bytes and closing the file.
+     * This is called once after all bytes have been passed to `write()`.
+     */
+    virtual void finish() = 0;
+};
+
+/**
+ * @brief Write bytes to an uncompressed file.
+ */
+class FileSink final : public Sink {
+public:
+    /**
+     * @param path Path to the output file.
+     * Any existing file at `path` is overwritten.
+     */
+    FileSink(const char* path) {
+        my_handle = std::fopen(path, "wb");
+        if (my_handle == NULL) {
+            throw std::runtime_error("failed to open file at '" + std::string(path) + "'");
+        }
+    }
+
+    /**
+     * @cond
+     */
+    ~FileSink() {
+        if (my_handle) {
+            std::fclose(my_handle);
+        }
+    }
+    /**
+     * @endcond
+     */
+
+private:
+    std::FILE* my_handle;
+
+public:
+    void write(const unsigned char* buffer, std::size_t n) {
+        if (std::fwrite(buffer, 1, n, my_handle) != n) {
+            throw std::runtime_error("failed to write to file");
+        }
+    }
+
+    void finish() {
+        if (my_handle) {
+            const int status = std::fclose(my_handle);
+            my_handle = NULL;
+            if (status != 0) {
+                throw std::runtime_error("failed to close file");
+            }
+        }
+    }
+};
+
+/**
+ * @brief Write bytes to an in-memory buffer.
+ */
+class BufferSink final : public Sink {
+private:
+    std::vector<unsigned char> my_contents;
+
+public:
+    void write(const unsigned char* buffer, std::size_t n) {
+        my_contents.insert(my_contents.end(), buffer, buffer + n);
+    }
+
+    void finish() {}
+
+    /**
+     * @return Contents of the buffer, i.e., all bytes that were passed to `write()`.
+     */
+    const std::vector<unsigned char>& get_contents() const {
+        return my_contents;
+    }
+
+    /**
+     * @return Contents of the buffer, which may be moved out of the `BufferSink` after all writing is complete.
+     */
+    std::vector<unsigned char>& get_contents() {
+        return my_contents;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,555 @@
+#ifndef EMINEM_WRITER_HPP
+#define EMINEM_WRITER_HPP
+
+#include <vector>
+#include <string>
+#include <complex>
+#include <type_traits>
+#include <stdexcept>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <limits>
+#include <algorithm>
+#include <charconv>
+#include <cstdio>
+#include <cstddef>
+
+#include "sanisizer/sanisizer.hpp"
+
+#include "utils.hpp"
+#include "Executor.hpp"
+#include "HalfFloat.hpp"
+#include "Sink.hpp"
+
+/**
+ * @file Writer.hpp
+ * @brief Write a matrix to a Matrix Market file.
+ */
+
+namespace eminem {
+
+/**
+ * @brief Options for the `Writer` constructor.
+ */
+struct WriterOptions {
+    /**
+     * Number of threads to use for formatting the data lines.
+     */
+    int num_threads = 1;
+
+    /**
+     * Number of data lines in each chunk.
+     * When `num_threads > 1`, each chunk is formatted by a separate job and the formatted chunks are passed to the sink in order.
+     * Larger values reduce the scheduling overhead at the cost of more memory, as up to `num_threads` formatted chunks may be held at once.
+     */
+    std::size_t chunk_lines = 65536;
+
+    /**
+     * Executor to run the formatting jobs when `num_threads > 1`, see `ParserOptions::executor` for details.
+     * If not provided, a new `PersistentThreadPool` is created with `num_threads` threads on the first parallelized call to `Writer::write_coordinate()` (or related methods),
+     * and is re-used for the lifetime of the `Writer`.
+     */
+    std::shared_ptr<Executor> executor;
+};
+
+/**
+ * @cond
+ */
+template<typename Type_>
+struct is_complex {
+    static constexpr bool value = false;
+};
+
+template<typename Type_>
+struct is_complex<std::complex<Type_> > {
+    static constexpr bool value = true;
+};
+/**
+ * @endcond
+ */
+
+/**
+ * @brief Write a matrix to a Matrix Market file.
+ *
+ * @tparam SinkPointer_ Class of the destination of output bytes.
+ * This should be a smart or raw pointer to an object satisfying the `Sink` interface.
+ * @tparam Index_ Integer type of the row/column indices.
+ *
+ * This is the counterpart to the `Parser`.
+ * Users should call `write_preamble()` to write the banner and size line, followed by one or more calls to `write_coordinate()` or `write_array()` (or related methods) to write the data lines in order.
+ * Finally, `finish()` should be called to check that the expected number of lines was written and to finish writing to the sink.
+ *
+ * Each batch of data lines is split into chunks that are formatted in parallel and then passed to the sink in order.
+ * Integers are formatted with `std::to_chars()`, while floating-point values are formatted with the shortest representation that round-trips back to the same value.
+ * Half-precision types like `Float16` are formatted via their `float` representation.
+ * If any method throws an exception, the contents of the sink are unspecified and the `Writer` should not be used further.
+ */
+template<class SinkPointer_, typename Index_ = unsigned long long>
+class Writer {
+public:
+    /**
+     * @param sink Destination of the output bytes.
+     * @param options Further options.
+     */
+    Writer(SinkPointer_ sink, const WriterOptions& options) :
+        my_sink(std::move(sink)),
+        my_num_threads(options.num_threads),
+        my_chunk_lines(std::max(options.chunk_lines, static_cast<std::size_t>(1))),
+        my_executor(options.executor)
+    {}
+
+private:
+    SinkPointer_ my_sink;
+    int my_num_threads;
+    std::size_t my_chunk_lines;
+    std::shared_ptr<Executor> my_executor;
+
+    MatrixDetails my_details;
+    Index_ my_nrows = 0, my_ncols = 0;
+    unsigned long long my_nlines = 0;
+    unsigned long long my_lines_written = 0;
+    bool my_passed_preamble = false;
+    bool my_finished = false;
+
+    std::vector<char> my_buffer;
+
+    struct Slot {
+        std::vector<char> buffer;
+        std::exception_ptr error;
+        bool done = true;
+    };
+    std::vector<Slot> my_slots;
+
+public:
+    /**
+     * @return Pointer to the destination of the output bytes.
+     */
+    const SinkPointer_& get_sink() const {
+        return my_sink;
+    }
+
+private:
+    static const char* object_name(Object object) {
+        return (object == Object::MATRIX ? "matrix" : "vector");
+    }
+
+    static const char* format_name(Format format) {
+        return (format == Format::COORDINATE ? "coordinate" : "array");
+    }
+
+    static const char* field_name(Field field) {
+        switch (field) {
+            case Field::INTEGER: return "integer";
+            case Field::REAL: return "real";
+            case Field::DOUBLE: return "double";
+            case Field::COMPLEX: return "complex";
+            default: return "pattern";
+        }
+    }
+
+    static const char* symmetry_name(Symmetry symmetry) {
+        switch (symmetry) {
+            case Symmetry::GENERAL: return "general";
+            case Symmetry::SYMMETRIC: return "symmetric";
+            case Symmetry::SKEW_SYMMETRIC: return "skew-symmetric";
+            default: return "hermitian";
+        }
+    }
+
+    void write_string(const std::string& x) {
+        my_sink->write(reinterpret_cast<const unsigned char*>(x.data()), x.size());
+    }
+
+public:
+    /**
+     * Write the banner and the size line.
+     * This should be called exactly once, before any of the data lines are written.
+     *
+     * @param details Details of the matrix, to be written in the banner.
+     * @param nrows Number of rows in the matrix or length of the vector.
+     * @param ncols Number of columns in the matrix.
+     * This is ignored for `Object::VECTOR`.
+     * @param nlines Number of data lines for `Format::COORDINATE`.
+     * This is ignored for `Format::ARRAY`, where the number of lines is implied by the dimensions.
+     */
+    void write_preamble(const MatrixDetails& details, Index_ nrows, Index_ ncols, unsigned long long nlines) {
+        if (my_passed_preamble) {
+            throw std::runtime_error("preamble has already been written");
+        }
+        if (details.symmetry == Symmetry::HERMITIAN && details.field != Field::COMPLEX) {
+            throw std::runtime_error("'hermitian' symmetry is only valid for the 'complex' field");
+        }
+        if (details.symmetry == Symmetry::SKEW_SYMMETRIC && details.field == Field::PATTERN) {
+            throw std::runtime_error("'skew-symmetric' symmetry is not valid for the 'pattern' field");
+        }
+        if (details.format == Format::ARRAY && details.field == Field::PATTERN) {
+            throw std::runtime_error("'array' format is not valid for the 'pattern' field");
+        }
+
+        my_details = details;
+        my_nrows = nrows;
+        my_ncols = (details.object == Object::MATRIX ? ncols : 1);
+
+        std::string preamble = "%%MatrixMarket ";
+        preamble += object_name(details.object);
+        preamble += ' ';
+        preamble += format_name(details.format);
+        preamble += ' ';
+        preamble += field_name(details.field);
+        preamble += ' ';
+        preamble += symmetry_name(details.symmetry);
+        preamble += '\n';
+
+        preamble += std::to_string(my_nrows);
+        if (details.object == Object::MATRIX) {
+            preamble += ' ';
+            preamble += std::to_string(my_ncols);
+        }
+        if (details.format == Format::COORDINATE) {
+            my_nlines = nlines;
+            preamble += ' ';
+            preamble += std::to_string(my_nlines);
+        } else {
+            my_nlines = sanisizer::product<unsigned long long>(my_nrows, my_ncols);
+        }
+        preamble += '\n';
+
+        write_string(preamble);
+        my_passed_preamble = true;
+    }
+
+    /**
+     * Finish writing the file.
+     * This checks that the number of data lines is consistent with the size line and calls `Sink::finish()`.
+     */
+    void finish() {
+        if (!my_passed_preamble) {
+            throw std::runtime_error("preamble has not yet been written");
+        }
+        if (my_finished) {
+            return;
+        }
+        if (my_lines_written != my_nlines) {
+            throw std::runtime_error("expected " + std::to_string(my_nlines) + " data lines but only " + std::to_string(my_lines_written) + " were written");
+        }
+        my_sink->finish();
+        my_finished = true;
+    }
+
+private:
+    /**************************
+     *** Formatting helpers ***
+     **************************/
+
+    static constexpr std::size_t index_width = std::numeric_limits<Index_>::digits10 + 2;
+
+    template<typename Type_>
+    static constexpr std::size_t value_width() {
+        if constexpr(is_complex<Type_>::value) {
+            return value_width<typename Type_::value_type>() * 2 + 1;
+        } else if constexpr(std::is_integral<Type_>::value) {
+            return std::numeric_limits<Type_>::digits10 + 3;
+        } else {
+            return 64; // generous bound for the shortest representation of a long double, or for the snprintf() fallback.
+        }
+    }
+
+    static char* format_index(char* ptr, Index_ x) {
+        return std::to_chars(ptr, ptr + index_width, x).ptr;
+    }
+
+    template<typename Type_>
+    static char* format_real(char* ptr, Type_ x) {
+#if defined(__cpp_lib_to_chars)
+        return std::to_chars(ptr, ptr + value_width<Type_>(), x).ptr;
+#else
+        int n;
+        if constexpr(std::is_same<Type_, long double>::value) {
+            n = std::snprintf(ptr, value_width<Type_>(), "%.*Lg", std::numeric_limits<Type_>::max_digits10, x);
+        } else {
+            n = std::snprintf(ptr, value_width<Type_>(), "%.*g", std::numeric_limits<Type_>::max_digits10, static_cast<double>(x));
+        }
+        return ptr + n;
+#endif
+    }
+
+    template<typename Type_>
+    static char* format_value(char* ptr, const Type_& x) {
+        if constexpr(is_complex<Type_>::value) {
+            ptr = format_value(ptr, x.real());
+            *ptr = ' ';
+            return format_value(ptr + 1, x.imag());
+        } else if constexpr(std::is_integral<Type_>::value) {
+            return std::to_chars(ptr, ptr + value_width<Type_>(), x).ptr;
+        } else if constexpr(is_half_float<Type_>::value) {
+            return format_real(ptr, static_cast<float>(x));
+        } else {
+            return format_real(ptr, x);
+        }
+    }
+
+    template<typename Type_>
+    void check_value_type() const {
+        static_assert(!std::is_same<Type_, bool>::value, "use the pattern methods to write a pattern field");
+        const auto field = my_details.field;
+        if constexpr(is_complex<Type_>::value) {
+            if (field != Field::COMPLEX) {
+                throw std::runtime_error("complex values can only be written for the 'complex' field");
+            }
+        } else if constexpr(std::is_integral<Type_>::value) {
+            if (field != Field::INTEGER && field != Field::REAL && field != Field::DOUBLE) {
+                throw std::runtime_error("integer values can only be written for the 'integer', 'real' or 'double' fields");
+            }
+        } else {
+            static_assert(std::is_floating_point<Type_>::value || is_half_float<Type_>::value);
+            if (field != Field::REAL && field != Field::DOUBLE) {
+                throw std::runtime_error("floating-point values can only be written for the 'real' or 'double' fields");
+            }
+        }
+    }
+
+    void check_data_lines(Format format, std::size_t n) const {
+        if (!my_passed_preamble) {
+            throw std::runtime_error("preamble has not yet been written");
+        }
+        if (my_finished) {
+            throw std::runtime_error("writing has already finished");
+        }
+        if (my_details.format != format) {
+            throw std::runtime_error(format == Format::COORDINATE ? "coordinate data lines can only be written for the 'coordinate' format" : "array data lines can only be written for the 'array' format");
+        }
+        if (static_cast<unsigned long long>(n) > my_nlines - my_lines_written) {
+            throw std::runtime_error("number of data lines exceeds that specified in the size line");
+        }
+    }
+
+    void check_indices(Index_ row, Index_ col, std::size_t i) const {
+        if (row < 1 || row > my_nrows) {
+            throw std::runtime_error("row index out of range for data line " + std::to_string(my_lines_written + i + 1));
+        }
+        if (col < 1 || col > my_ncols) {
+            throw std::runtime_error("column index out of range for data line " + std::to_string(my_lines_written + i + 1));
+        }
+    }
+
+private:
+    /*************************
+     *** Chunked execution ***
+     *************************/
+
+    // 'format' should accept the start and end of a range of lines as well as a pointer to a buffer,
+    // and return the pointer to the end of the formatted bytes in the buffer.
+    template<class Format_>
+    void write_chunks(std::size_t n, std::size_t line_width, Format_ format) {
+        if (n == 0) {
+            return;
+        }
+
+        const std::size_t nchunks = n / my_chunk_lines + (n % my_chunk_lines > 0);
+        auto format_chunk = [&](std::size_t c, std::vector<char>& buffer) -> void {
+            const std::size_t start = c * my_chunk_lines;
+            const std::size_t end = start + std::min(my_chunk_lines, n - start);
+            buffer.resize(sanisizer::product<std::size_t>(end - start, line_width));
+            char* last = format(start, end, buffer.data());
+            buffer.resize(last - buffer.data());
+        };
+        auto flush = [&](const std::vector<char>& buffer) -> void {
+            my_sink->write(reinterpret_cast<const unsigned char*>(buffer.data()), buffer.size());
+        };
+
+        if (my_num_threads <= 1 || nchunks == 1) {
+            for (std::size_t c = 0; c < nchunks; ++c) {
+                format_chunk(c, my_buffer);
+                flush(my_buffer);
+            }
+            my_lines_written += n;
+            return;
+        }
+
+        if (!my_executor) {
+            my_executor = std::make_shared<PersistentThreadPool>(my_num_threads);
+        }
+
+        // Each batch should have no more than 'num_threads' jobs in the executor at any given time, see the Executor documentation.
+        const std::size_t nslots = std::min(static_cast<std::size_t>(my_num_threads), nchunks);
+        if (my_slots.size() < nslots) {
+            my_slots.resize(nslots);
+        }
+        std::mutex mut;
+        std::condition_variable cv;
+
+        auto submit = [&](std::size_t c) -> void {
+            auto& slot = my_slots[c % nslots];
+            slot.done = false;
+            slot.error = nullptr;
+            my_executor->submit([&, c]() -> void {
+                auto& slot = my_slots[c % nslots];
+                try {
+                    format_chunk(c, slot.buffer);
+                } catch (...) {
+                    slot.error = std::current_exception();
+                }
+                std::lock_guard lck(mut);
+                slot.done = true;
+                cv.notify_all(); // notifying while the lock is held, as 'cv' may be destroyed as soon as the lock is released.
+            });
+        };
+
+        std::size_t next = 0;
+        for (; next < nslots; ++next) {
+            submit(next);
+        }
+
+        std::exception_ptr error;
+        std::size_t current = 0;
+        for (; current < nchunks; ++current) {
+            auto& slot = my_slots[current % nslots];
+            {
+                std::unique_lock lck(mut);
+                cv.wait(lck, [&]() -> bool { return slot.done; });
+            }
+            if (slot.error) {
+                error = slot.error;
+                break;
+            }
+
+            try {
+                flush(slot.buffer);
+            } catch (...) {
+                error = std::current_exception();
+                break;
+            }
+
+            if (next < nchunks) {
+                submit(next);
+                ++next;
+            }
+        }
+
+        if (error) {
+            // Waiting for all submitted jobs to finish before the stack is unwound, as they refer to local variables.
+            std::unique_lock lck(mut);
+            for (std::size_t c = current + 1; c < next; ++c) {
+                auto& slot = my_slots[c % nslots];
+                cv.wait(lck, [&]() -> bool { return slot.done; });
+            }
+            std::rethrow_exception(error);
+        }
+
+        my_lines_written += n;
+    }
+
+public:
+    /**
+     * Write a batch of data lines for a coordinate matrix or vector.
+     * This can be called multiple times to write the data lines in consecutive batches.
+     *
+     * @tparam Type_ Type of the value.
+     * This should be an integer type for `Field::INTEGER`; an integer, floating-point or half-precision type for `Field::REAL` or `Field::DOUBLE`;
+     * or a `std::complex` for `Field::COMPLEX`.
+     *
+     * @param n Number of data lines in this batch.
+     * @param rows Pointer to an array of length `n` containing the 1-based row indices.
+     * @param columns Pointer to an array of length `n` containing the 1-based column indices.
+     * This is ignored for `Object::VECTOR`, and may be NULL.
+     * @param values Pointer to an array of length `n` containing the values.
+     */
+    template<typename Type_>
+    void write_coordinate(std::size_t n, const Index_* rows, const Index_* columns, const Type_* values) {
+        check_data_lines(Format::COORDINATE, n);
+        check_value_type<Type_>();
+
+        if (my_details.object == Object::MATRIX) {
+            write_chunks(n, index_width * 2 + value_width<Type_>() + 3, [&](std::size_t start, std::size_t end, char* ptr) -> char* {
+                for (std::size_t i = start; i < end; ++i) {
+                    check_indices(rows[i], columns[i], i);
+                    ptr = format_index(ptr, rows[i]);
+                    *(ptr++) = ' ';
+                    ptr = format_index(ptr, columns[i]);
+                    *(ptr++) = ' ';
+                    ptr = format_value(ptr, values[i]);
+                    *(ptr++) = '\n';
+                }
+                return ptr;
+            });
+        } else {
+            write_chunks(n, index_width + value_width<Type_>() + 2, [&](std::size_t start, std::size_t end, char* ptr) -> char* {
+                for (std::size_t i = start; i < end; ++i) {
+                    check_indices(rows[i], 1, i);
+                    ptr = format_index(ptr, rows[i]);
+                    *(ptr++) = ' ';
+                    ptr = format_value(ptr, values[i]);
+                    *(ptr++) = '\n';
+                }
+                return ptr;
+            });
+        }
+    }
+
+    /**
+     * Write a batch of data lines for a coordinate matrix or vector with a pattern field.
+     * This can be called multiple times to write the data lines in consecutive batches.
+     *
+     * @param n Number of data lines in this batch.
+     * @param rows Pointer to an array of length `n` containing the 1-based row indices.
+     * @param columns Pointer to an array of length `n` containing the 1-based column indices.
+     * This is ignored for `Object::VECTOR`, and may be NULL.
+     */
+    void write_coordinate_pattern(std::size_t n, const Index_* rows, const Index_* columns) {
+        check_data_lines(Format::COORDINATE, n);
+        if (my_details.field != Field::PATTERN) {
+            throw std::runtime_error("pattern data lines can only be written for the 'pattern' field");
+        }
+
+        if (my_details.object == Object::MATRIX) {
+            write_chunks(n, index_width * 2 + 2, [&](std::size_t start, std::size_t end, char* ptr) -> char* {
+                for (std::size_t i = start; i < end; ++i) {
+                    check_indices(rows[i], columns[i], i);
+                    ptr = format_index(ptr, rows[i]);
+                    *(ptr++) = ' ';
+                    ptr = format_index(ptr, columns[i]);
+                    *(ptr++) = '\n';
+                }
+                return ptr;
+            });
+        } else {
+            write_chunks(n, index_width + 1, [&](std::size_t start, std::size_t end, char* ptr) -> char* {
+                for (std::size_t i = start; i < end; ++i) {
+                    check_indices(rows[i], 1, i);
+                    ptr = format_index(ptr, rows[i]);
+                    *(ptr++) = '\n';
+                }
+                return ptr;
+            });
+        }
+    }
+
+    /**
+     * Write a batch of data lines for an array matrix or vector.
+     * Values should be supplied in column-major order, and this can be called multiple times to write the values in consecutive batches.
+     *
+     * @tparam Type_ Type of the value, see `write_coordinate()` for details.
+     *
+     * @param n Number of data lines in this batch.
+     * @param values Pointer to an array of length `n` containing the values.
+     */
+    template<typename Type_>
+    void write_array(std::size_t n, const Type_* values) {
+        check_data_lines(Format::ARRAY, n);
+        check_value_type<Type_>();
+
+        write_chunks(n, value_width<Type_>() + 1, [&](std::size_t start, std::size_t end, char* ptr) -> char* {
+            for (std::size_t i = start; i < end; ++i) {
+                ptr = format_value(ptr, values[i]);
+                *(ptr++) = '\n';
+            }
+            return ptr;
+        });
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,134 @@
+#ifndef EMINEM_CHOOSE_OPTIONS_HPP
+#define EMINEM_CHOOSE_OPTIONS_HPP
+
+#include <fstream>
+#include <algorithm>
+#include <thread>
+#include <stdexcept>
+#include <cstddef>
+
+#include "sanisizer/sanisizer.hpp"
+
+#include "Parser.hpp"
+
+/**
+ * @file choose_options.hpp
+ * @brief Automatically choose the parsing options for a file.
+ */
+
+namespace eminem {
+
+/**
+ * @brief Options for `choose_options()`.
+ */
+struct ChooseOptionsOptions {
+    /**
+     * Maximum number of threads to use.
+     * If zero, this is set to `std::thread::hardware_concurrency()`.
+     */
+    int max_threads = 0;
+
+    /**
+     * Minimum number of (uncompressed) bytes to be processed by each thread.
+     * Inputs that are smaller than twice this value will be parsed serially, as the overhead of parallelization outweighs any speed-up.
+     */
+    std::size_t min_bytes_per_thread = sanisizer::cap<std::size_t>(1048576);
+
+    /**
+     * Expected ratio of the uncompressed size to the compressed size, used to estimate the size of the Matrix Market file from a compressed input.
+     */
+    double compression_ratio = 4;
+
+    /**
+     * Number of chunks to be processed by each thread in a parallel scan.
+     * Larger values reduce the imbalance in the workload between threads but increase the synchronization overhead.
+     */
+    int chunks_per_thread = 8;
+
+    /**
+     * Minimum size of the buffer, see `ParserOptions::buffer_size`.
+     */
+    std::size_t min_buffer_size = sanisizer::cap<std::size_t>(65536);
+
+    /**
+     * Maximum size of the buffer, see `ParserOptions::buffer_size`.
+     */
+    std::size_t max_buffer_size = sanisizer::cap<std::size_t>(16777216);
+};
+
+/**
+ * Choose the number of threads and the buffer size for parsing an input of a known size.
+ * Small inputs are parsed serially with a buffer size of `ChooseOptionsOptions::min_buffer_size`.
+ * For larger inputs, we use as many threads as possible while still giving each thread at least `ChooseOptionsOptions::min_bytes_per_thread` bytes,
+ * and then choose a buffer size so that each thread processes `ChooseOptionsOptions::chunks_per_thread` chunks.
+ *
+ * @param num_bytes Number of bytes in the input.
+ * @param compressed Whether the input is compressed.
+ * If `true`, the uncompressed size is estimated from `num_bytes` and `ChooseOptionsOptions::compression_ratio`.
+ * @param options Further options.
+ *
+ * @return Options for constructing a `Parser`.
+ * All fields other than `ParserOptions::num_threads` and `ParserOptions::buffer_size` are set to their defaults.
+ */
+inline ParserOptions choose_options(unsigned long long num_bytes, bool compressed, const ChooseOptionsOptions& options) {
+    double expected = num_bytes;
+    if (compressed) {
+        expected *= options.compression_ratio;
+    }
+
+    int max_threads = options.max_threads;
+    if (max_threads <= 0) {
+        max_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    ParserOptions output;
+    output.buffer_size = options.min_buffer_size;
+
+    const double per_thread = std::max(static_cast<std::size_t>(1), options.min_bytes_per_thread);
+    const double possible_threads = expected / per_thread; // avoid integer overflow by staying in floating-point.
+    if (possible_threads < 2 || max_threads == 1) {
+        output.num_threads = 1;
+        return output;
+    }
+    output.num_threads = (possible_threads >= max_threads ? max_threads : static_cast<int>(possible_threads));
+
+    const double per_chunk = expected / (static_cast<double>(output.num_threads) * std::max(1, options.chunks_per_thread));
+    if (per_chunk >= options.max_buffer_size) {
+        output.buffer_size = options.max_buffer_size;
+    } else if (per_chunk > options.min_buffer_size) {
+        output.buffer_size = per_chunk;
+    }
+
+    return output;
+}
+
+/**
+ * Choose the number of threads and the buffer size for parsing a Matrix Market file, based on its size.
+ * Gzip-compressed files are automatically detected from the magic number.
+ *
+ * @param path Pointer to a string containing a path to a possibly-compressed Matrix Market file.
+ * @param options Further options.
+ *
+ * @return Options for constructing a `Parser`, see the other `choose_options()` overload for details.
+ */
+inline ParserOptions choose_options(const char* path, const ChooseOptionsOptions& options) {
+    std::ifstream handle(path, std::ios::binary | std::ios::ate);
+    if (!handle) {
+        throw std::runtime_error("failed to open file at '" + std::string(path) + "'");
+    }
+    unsigned long long num_bytes = handle.tellg();
+
+    bool compressed = false;
+    if (num_bytes >= 2) {
+        handle.seekg(0);
+        char magic[2];
+        handle.read(magic, 2);
+        compressed = (static_cast<unsigned char>(magic[0]) == 0x1f && static_cast<unsigned char>(magic[1]) == 0x8b);
+    }
+
+    return choose_options(num_bytes, compressed, options);
+}
+
+}
+
+#endif
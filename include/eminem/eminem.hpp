@@ -3,9 +3,17 @@
 
 #include "Parser.hpp"
 #include "from_text.hpp"
+#include "choose_options.hpp"
+#include "HugePageResource.hpp"
+#include "HalfFloat.hpp"
+#include "ParserStats.hpp"
+#include "narrow.hpp"
+#include "Writer.hpp"
+#include "to_text.hpp"
 
 #if __has_include("zlib.h")
 #include "from_gzip.hpp"
+#include "to_gzip.hpp"
 #endif
 
 /**
@@ -13,12 +21,12 @@
  * @brief Umbrella header for the **eminem** library.
  *
  * If ZLib is not available, all of the Zlib-related headers are omitted.
- * This will skip classes such as the `GzipFileParser` and `SomeBufferParser`.
+ * This will skip classes such as the `GzipFileParser`, `SomeBufferParser` and `GzipSink`.
  */
 
 /**
  * @namespace eminem
- * @brief Classes and methods for parsing Matrix Market files.
+ * @brief Classes and methods for parsing and writing Matrix Market files.
  */
 namespace eminem {}
 
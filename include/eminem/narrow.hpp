@@ -0,0 +1,178 @@
+#ifndef EMINEM_NARROW_HPP
+#define EMINEM_NARROW_HPP
+
+#include <cstdint>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+
+#include "Parser.hpp"
+
+/**
+ * @file narrow.hpp
+ * @brief Choose the narrowest types for storing the parsed indices and values.
+ */
+
+namespace eminem {
+
+/**
+ * Call a function with the narrowest standard integer type that can represent all values in a range.
+ * Unsigned types are used if `lower` is non-negative, otherwise signed types are used.
+ * Signed types are only considered if `Integer_` is itself signed.
+ *
+ * @tparam Integer_ Integer type of the range limits.
+ * @tparam Function_ Function that accepts a single argument of any integer type.
+ *
+ * @param lower Lower limit of the range, inclusive.
+ * @param upper Upper limit of the range, inclusive.
+ * This should be no less than `lower`.
+ * @param fun Function to be called with a value-initialized instance of the chosen type, i.e., one of `std::uint8_t`, `std::int8_t`, ..., `std::uint64_t`, `std::int64_t`.
+ * The function should use the type of its argument (e.g., via `decltype`) to determine the storage type.
+ * It should return the same type for all integer arguments.
+ *
+ * @return The return value of `fun`.
+ */
+template<typename Integer_, class Function_>
+decltype(auto) dispatch_narrowest_integer(Integer_ lower, Integer_ upper, Function_ fun) {
+    static_assert(std::is_integral<Integer_>::value);
+
+    auto fits = [&](auto candidate) -> bool {
+        typedef decltype(candidate) Candidate;
+        // Comparisons are done in the wider of the two types, taking care to avoid sign conversions.
+        if constexpr(std::is_signed<Integer_>::value) {
+            if constexpr(std::is_signed<Candidate>::value) {
+                return static_cast<std::intmax_t>(lower) >= static_cast<std::intmax_t>(std::numeric_limits<Candidate>::min()) &&
+                    static_cast<std::intmax_t>(upper) <= static_cast<std::intmax_t>(std::numeric_limits<Candidate>::max());
+            } else {
+                return lower >= 0 && static_cast<std::uintmax_t>(upper) <= static_cast<std::uintmax_t>(std::numeric_limits<Candidate>::max());
+            }
+        } else {
+            return static_cast<std::uintmax_t>(upper) <= static_cast<std::uintmax_t>(std::numeric_limits<Candidate>::max());
+        }
+    };
+
+    // Only instantiating the signed types if the range could be negative, so that 'fun' can assume unsigned types for unsigned ranges.
+    if constexpr(std::is_signed<Integer_>::value) {
+        if (lower < 0) {
+            if (fits(std::int8_t())) {
+                return fun(std::int8_t());
+            } else if (fits(std::int16_t())) {
+                return fun(std::int16_t());
+            } else if (fits(std::int32_t())) {
+                return fun(std::int32_t());
+            } else {
+                return fun(std::int64_t());
+            }
+        }
+    }
+
+    if (fits(std::uint8_t())) {
+        return fun(std::uint8_t());
+    } else if (fits(std::uint16_t())) {
+        return fun(std::uint16_t());
+    } else if (fits(std::uint32_t())) {
+        return fun(std::uint32_t());
+    } else {
+        return fun(std::uint64_t());
+    }
+}
+
+/**
+ * Call a function with the narrowest unsigned integer type that can represent the row and column indices of a Matrix Market file.
+ * This considers the number of rows and columns in the size line, which is an upper bound on the indices as enforced by `Parser`.
+ * It is typically used to choose a compact type for storing the indices after `Parser::scan_preamble()` but before calling `Parser::scan_integer()` or friends.
+ *
+ * @tparam Parser_ A `Parser` instance.
+ * @tparam Function_ Function that accepts a single argument of any unsigned integer type.
+ *
+ * @param parser The parser, after calling `Parser::scan_preamble()`.
+ * @param fun Function to be called with a value-initialized instance of the chosen type, i.e., one of `std::uint8_t`, `std::uint16_t`, `std::uint32_t` or `std::uint64_t`.
+ * The indices passed to the store function of each `Parser::scan_integer()` (or friends) call can then be safely cast to this type.
+ * The function should return the same type for all integer arguments.
+ *
+ * @return The return value of `fun`.
+ */
+template<class Parser_, class Function_>
+decltype(auto) dispatch_narrowest_index(const Parser_& parser, Function_ fun) {
+    const auto upper = std::max(parser.get_nrows(), parser.get_ncols());
+    return dispatch_narrowest_integer(static_cast<decltype(upper)>(0), upper, std::move(fun));
+}
+
+/**
+ * @brief Observed range of integer values.
+ *
+ * @tparam Type_ Integer type of the values.
+ *
+ * This is intended to be updated with each value in the store function of `Parser::scan_integer()`,
+ * after which it reports the range of values so that the caller can choose a compact storage type.
+ * For example, a caller could collect the values into a temporary vector of `Type_`, then copy them into a vector of the narrowest type;
+ * or perform a second scan of the file, storing the values directly in the narrowest type.
+ */
+template<typename Type_ = int>
+class ValueRange {
+public:
+    /**
+     * @param value Value to add to the range.
+     */
+    void add(Type_ value) {
+        my_min = std::min(my_min, value);
+        my_max = std::max(my_max, value);
+        ++my_count;
+    }
+
+    /**
+     * @return Whether no values have been added.
+     */
+    bool empty() const {
+        return my_count == 0;
+    }
+
+    /**
+     * @return Number of values that have been added.
+     */
+    LineIndex count() const {
+        return my_count;
+    }
+
+    /**
+     * @return Smallest value that has been added.
+     * If `empty()` is true, this is the largest value of `Type_`.
+     */
+    Type_ min() const {
+        return my_min;
+    }
+
+    /**
+     * @return Largest value that has been added.
+     * If `empty()` is true, this is the smallest value of `Type_`.
+     */
+    Type_ max() const {
+        return my_max;
+    }
+
+    /**
+     * Call a function with the narrowest standard integer type that can represent all values that have been added, see `dispatch_narrowest_integer()`.
+     * If `empty()` is true, the narrowest unsigned type is used.
+     *
+     * @tparam Function_ Function that accepts a single argument of any integer type.
+     * @param fun Function to be called with a value-initialized instance of the chosen type.
+     * @return The return value of `fun`.
+     */
+    template<class Function_>
+    decltype(auto) dispatch_narrowest(Function_ fun) const {
+        if (empty()) {
+            return dispatch_narrowest_integer(static_cast<Type_>(0), static_cast<Type_>(0), std::move(fun));
+        } else {
+            return dispatch_narrowest_integer(my_min, my_max, std::move(fun));
+        }
+    }
+
+private:
+    Type_ my_min = std::numeric_limits<Type_>::max();
+    Type_ my_max = std::numeric_limits<Type_>::lowest();
+    LineIndex my_count = 0;
+};
+
+}
+
+#endif
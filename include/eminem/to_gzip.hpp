@@ -0,0 +1,285 @@
+#ifndef EMINEM_TO_GZIP_HPP
+#define EMINEM_TO_GZIP_HPP
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+#include <limits>
+#include <cstdio>
+#include <cstring>
+#include <cstddef>
+
+#include "zlib.h"
+
+#include "Writer.hpp"
+#include "Sink.hpp"
+#include "Executor.hpp"
+
+/**
+ * @file to_gzip.hpp
+ * @brief Write a Gzipped Matrix Market file.
+ */
+
+namespace eminem {
+
+/**
+ * @brief Options for the `GzipSink` constructor.
+ */
+struct GzipSinkOptions {
+    /**
+     * Compression level, from 0 (no compression) to 9 (maximum compression), or -1 for Zlib's default.
+     */
+    int compression_level = 6;
+
+    /**
+     * Number of uncompressed bytes in each block.
+     * Each block is compressed independently into a separate Gzip member.
+     * Larger values slightly improve the compression ratio at the cost of more memory.
+     */
+    std::size_t block_size = 1048576;
+
+    /**
+     * Number of threads to use for compression.
+     */
+    int num_threads = 1;
+
+    /**
+     * Executor to run the compression jobs when `num_threads > 1`, see `ParserOptions::executor` for details.
+     * If not provided, a new `PersistentThreadPool` is created with `num_threads` threads for the lifetime of the `GzipSink`.
+     */
+    std::shared_ptr<Executor> executor;
+};
+
+/**
+ * @brief Write bytes to a Gzip-compressed file.
+ *
+ * The incoming bytes are split into blocks of `GzipSinkOptions::block_size`, each of which is compressed into a separate Gzip member.
+ * Blocks are compressed in parallel when `GzipSinkOptions::num_threads > 1` and written to the file in order.
+ * The concatenation of members is a valid Gzip file that can be read by `parse_gzip_file()` or by standard tools like `gunzip`.
+ */
+class GzipSink final : public Sink {
+public:
+    /**
+     * @param path Path to the output file.
+     * Any existing file at `path` is overwritten.
+     * @param options Further options.
+     */
+    GzipSink(const char* path, const GzipSinkOptions& options) :
+        my_num_threads(std::max(options.num_threads, 1)),
+        my_block_size(options.block_size),
+        my_executor(options.executor)
+    {
+        if (my_block_size == 0 || my_block_size > std::numeric_limits<unsigned int>::max() / 2) {
+            throw std::runtime_error("block size should be positive and less than 2^31 bytes");
+        }
+
+        // Each slot holds its own z_stream, which must not be moved after initialization.
+        for (int t = 0; t < my_num_threads; ++t) {
+            my_slots.emplace_back(std::make_unique<Slot>(options.compression_level));
+        }
+        if (my_num_threads > 1 && !my_executor) {
+            my_executor = std::make_shared<PersistentThreadPool>(my_num_threads);
+        }
+
+        my_handle = std::fopen(path, "wb");
+        if (my_handle == NULL) {
+            throw std::runtime_error("failed to open file at '" + std::string(path) + "'");
+        }
+    }
+
+    /**
+     * @cond
+     */
+    ~GzipSink() {
+        // Waiting for all jobs to finish, as they refer to the slots.
+        std::unique_lock lck(my_mut);
+        for (const auto& slot : my_slots) {
+            my_cv.wait(lck, [&]() -> bool { return slot->done; });
+        }
+        lck.unlock();
+
+        if (my_handle) {
+            std::fclose(my_handle);
+        }
+    }
+    /**
+     * @endcond
+     */
+
+private:
+    struct Slot {
+        Slot(int level) {
+            std::memset(&stream, 0, sizeof(z_stream));
+            if (deflateInit2(&stream, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) { // 15 + 16 to write a Gzip header.
+                throw std::runtime_error("failed to initialize the Zlib stream");
+            }
+        }
+
+        ~Slot() {
+            deflateEnd(&stream);
+        }
+
+        Slot(const Slot&) = delete;
+        Slot& operator=(const Slot&) = delete;
+
+        z_stream stream;
+        std::vector<unsigned char> input, output;
+        std::exception_ptr error;
+        bool pending = false; // submitted but not yet written to file.
+        bool done = true; // compression is complete.
+    };
+
+    int my_num_threads;
+    std::size_t my_block_size;
+    std::shared_ptr<Executor> my_executor;
+
+    std::vector<std::unique_ptr<Slot> > my_slots;
+    std::size_t my_filling = 0;
+    bool my_any_dispatched = false;
+    std::mutex my_mut;
+    std::condition_variable my_cv;
+
+    std::FILE* my_handle = NULL;
+
+private:
+    static void compress(Slot& slot) {
+        auto& stream = slot.stream;
+        if (deflateReset(&stream) != Z_OK) {
+            throw std::runtime_error("failed to reset the Zlib stream");
+        }
+        slot.output.resize(deflateBound(&stream, slot.input.size()));
+        stream.next_in = slot.input.data();
+        stream.avail_in = slot.input.size();
+        stream.next_out = slot.output.data();
+        stream.avail_out = slot.output.size();
+        if (deflate(&stream, Z_FINISH) != Z_STREAM_END) {
+            throw std::runtime_error("failed to compress a block");
+        }
+        slot.output.resize(slot.output.size() - stream.avail_out);
+    }
+
+    void flush(Slot& slot) {
+        if (std::fwrite(slot.output.data(), 1, slot.output.size(), my_handle) != slot.output.size()) {
+            throw std::runtime_error("failed to write to file");
+        }
+        slot.input.clear();
+    }
+
+    // Waits for a pending slot to finish compression and writes it to file, so that it can be filled again.
+    // Slots are submitted in ring order, so the next slot to be filled is always the oldest pending slot.
+    void reclaim(Slot& slot) {
+        if (!slot.pending) {
+            return;
+        }
+        {
+            std::unique_lock lck(my_mut);
+            my_cv.wait(lck, [&]() -> bool { return slot.done; });
+        }
+        slot.pending = false;
+        if (slot.error) {
+            std::rethrow_exception(slot.error);
+        }
+        flush(slot);
+    }
+
+    void dispatch() {
+        my_any_dispatched = true;
+        auto& slot = *(my_slots[my_filling]);
+        if (my_num_threads == 1) {
+            compress(slot);
+            flush(slot);
+            return;
+        }
+
+        slot.pending = true;
+        slot.done = false;
+        slot.error = nullptr;
+        my_executor->submit([this, &slot]() -> void {
+            try {
+                compress(slot);
+            } catch (...) {
+                slot.error = std::current_exception();
+            }
+            std::lock_guard lck(my_mut);
+            slot.done = true;
+            my_cv.notify_all();
+        });
+
+        my_filling = (my_filling + 1) % my_slots.size();
+        reclaim(*(my_slots[my_filling]));
+    }
+
+public:
+    void write(const unsigned char* buffer, std::size_t n) {
+        while (n) {
+            auto& input = my_slots[my_filling]->input;
+            const std::size_t take = std::min(n, my_block_size - input.size());
+            input.insert(input.end(), buffer, buffer + take);
+            buffer += take;
+            n -= take;
+            if (input.size() == my_block_size) {
+                dispatch();
+            }
+        }
+    }
+
+    void finish() {
+        if (my_handle == NULL) {
+            return;
+        }
+
+        // Always writing at least one member so that an empty input still yields a valid Gzip file.
+        if (!my_any_dispatched || !my_slots[my_filling]->input.empty()) {
+            dispatch();
+        }
+        const auto nslots = my_slots.size();
+        for (std::size_t s = 0; s < nslots; ++s) {
+            reclaim(*(my_slots[(my_filling + s) % nslots]));
+        }
+
+        const int status = std::fclose(my_handle);
+        my_handle = NULL;
+        if (status != 0) {
+            throw std::runtime_error("failed to close file");
+        }
+    }
+};
+
+/**
+ * Write a Gzip-compressed Matrix Market file.
+ * The formatting of the data lines and their compression are both parallelized across `WriterOptions::num_threads` threads.
+ * To use a different number of threads or block size for compression, users should construct a `Writer` with a `GzipSink` directly.
+ *
+ * @tparam Index_ Integer type of the row/column indices.
+ *
+ * @param path Pointer to a string containing the path to the output file.
+ * @param options Further options.
+ * @param compression_level Compression level, see `GzipSinkOptions::compression_level`.
+ *
+ * @return A `Writer` instance that writes to `path`.
+ * This uses `Index_` as the integer type of its row/column indices.
+ */
+template<typename Index_ = unsigned long long>
+auto write_gzip_file(const char* path, const WriterOptions& options, int compression_level = 6) {
+    auto wopt = options;
+    if (wopt.num_threads > 1 && !wopt.executor) {
+        wopt.executor = std::make_shared<PersistentThreadPool>(wopt.num_threads); // sharing the same pool for formatting and compression.
+    }
+
+    GzipSinkOptions gopt;
+    gopt.compression_level = compression_level;
+    gopt.num_threads = wopt.num_threads;
+    gopt.executor = wopt.executor;
+
+    auto sink = std::make_unique<GzipSink>(path, gopt);
+    return Writer<decltype(sink), Index_>(std::move(sink), wopt);
+}
+
+}
+
+#endif
@@ -0,0 +1,52 @@
+#ifndef EMINEM_TO_TEXT_HPP
+#define EMINEM_TO_TEXT_HPP
+
+#include <memory>
+
+#include "Writer.hpp"
+#include "Sink.hpp"
+
+/**
+ * @file to_text.hpp
+ * @brief Write a Matrix Market file as text.
+ */
+
+namespace eminem {
+
+/**
+ * Write an uncompressed Matrix Market text file.
+ *
+ * @tparam Index_ Integer type of the row/column indices.
+ *
+ * @param path Pointer to a string containing the path to the output file.
+ * @param options Further options.
+ *
+ * @return A `Writer` instance that writes to `path`.
+ * This uses `Index_` as the integer type of its row/column indices.
+ */
+template<typename Index_ = unsigned long long>
+auto write_text_file(const char* path, const WriterOptions& options) {
+    auto sink = std::make_unique<FileSink>(path);
+    return Writer<decltype(sink), Index_>(std::move(sink), options);
+}
+
+/**
+ * Write an uncompressed Matrix Market file to an in-memory buffer.
+ *
+ * @tparam Index_ Integer type of the row/column indices.
+ *
+ * @param options Further options.
+ *
+ * @return A `Writer` instance that writes to a `BufferSink`.
+ * The contents can be retrieved with `Writer::get_sink()` followed by `BufferSink::get_contents()`.
+ * This uses `Index_` as the integer type of its row/column indices.
+ */
+template<typename Index_ = unsigned long long>
+auto write_text_buffer(const WriterOptions& options) {
+    auto sink = std::make_unique<BufferSink>();
+    return Writer<decltype(sink), Index_>(std::move(sink), options);
+}
+
+}
+
+#endif
@@ -0,0 +1,362 @@
+#include "eminem/eminem.hpp"
+#include "generate.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <atomic>
+#include <new>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdlib>
+#include <cstddef>
+#include <cerrno>
+
+#ifdef __GLIBC__
+#include <malloc.h>
+#endif
+
+// Counts the heap allocations in each scan mode, reporting the number of allocations per MB parsed and the peak heap usage.
+// This allows the removal of allocations from the parser to be tracked as a regression metric.
+
+/*****************************
+ *** Allocation accounting ***
+ *****************************/
+
+namespace {
+
+std::atomic<unsigned long long> num_allocations(0);
+std::atomic<unsigned long long> allocated_bytes(0);
+std::atomic<long long> current_bytes(0);
+std::atomic<long long> peak_bytes(0);
+
+void record_allocation(std::size_t n) {
+    num_allocations.fetch_add(1, std::memory_order_relaxed);
+    allocated_bytes.fetch_add(n, std::memory_order_relaxed);
+    const long long now = current_bytes.fetch_add(n, std::memory_order_relaxed) + static_cast<long long>(n);
+    long long peak = peak_bytes.load(std::memory_order_relaxed);
+    while (now > peak && !peak_bytes.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {}
+}
+
+void record_release(std::size_t n) {
+    current_bytes.fetch_sub(n, std::memory_order_relaxed);
+}
+
+}
+
+#ifdef __GLIBC__
+// On glibc, we interpose the malloc() family itself, which also captures operator new (as libstdc++ allocates with malloc())
+// as well as any allocations from C libraries like zlib. Sizes are taken from malloc_usable_size() so no extra header is needed.
+extern "C" {
+
+void* __libc_malloc(std::size_t);
+void* __libc_calloc(std::size_t, std::size_t);
+void* __libc_realloc(void*, std::size_t);
+void* __libc_memalign(std::size_t, std::size_t);
+void* __libc_valloc(std::size_t);
+void* __libc_pvalloc(std::size_t);
+void __libc_free(void*);
+
+void* malloc(std::size_t n) noexcept {
+    void* ptr = __libc_malloc(n);
+    if (ptr) {
+        record_allocation(malloc_usable_size(ptr));
+    }
+    return ptr;
+}
+
+void* calloc(std::size_t count, std::size_t n) noexcept {
+    void* ptr = __libc_calloc(count, n);
+    if (ptr) {
+        record_allocation(malloc_usable_size(ptr));
+    }
+    return ptr;
+}
+
+void* realloc(void* old, std::size_t n) noexcept {
+    const std::size_t old_size = (old ? malloc_usable_size(old) : 0);
+    void* ptr = __libc_realloc(old, n);
+    if (ptr) {
+        record_release(old_size);
+        record_allocation(malloc_usable_size(ptr));
+    } else if (old && n == 0) {
+        record_release(old_size); // realloc(ptr, 0) frees the pointer in glibc.
+    }
+    return ptr;
+}
+
+void* memalign(std::size_t alignment, std::size_t n) noexcept {
+    void* ptr = __libc_memalign(alignment, n);
+    if (ptr) {
+        record_allocation(malloc_usable_size(ptr));
+    }
+    return ptr;
+}
+
+void* valloc(std::size_t n) noexcept {
+    void* ptr = __libc_valloc(n);
+    if (ptr) {
+        record_allocation(malloc_usable_size(ptr));
+    }
+    return ptr;
+}
+
+void* pvalloc(std::size_t n) noexcept {
+    void* ptr = __libc_pvalloc(n);
+    if (ptr) {
+        record_allocation(malloc_usable_size(ptr));
+    }
+    return ptr;
+}
+
+void* aligned_alloc(std::size_t alignment, std::size_t n) noexcept {
+    return memalign(alignment, n);
+}
+
+int posix_memalign(void** output, std::size_t alignment, std::size_t n) noexcept {
+    void* ptr = memalign(alignment, n);
+    if (ptr == NULL) {
+        return ENOMEM;
+    }
+    *output = ptr;
+    return 0;
+}
+
+void free(void* ptr) noexcept {
+    if (ptr) {
+        record_release(malloc_usable_size(ptr));
+        __libc_free(ptr);
+    }
+}
+
+}
+
+#else
+// Elsewhere, we can only portably replace the global operator new/delete.
+// Each allocation is prefixed with a header holding its size; aligned and C-level allocations are not counted.
+namespace {
+
+constexpr std::size_t header_size = alignof(std::max_align_t);
+
+void* counted_new(std::size_t n) {
+    void* ptr = std::malloc(n + header_size);
+    if (ptr == NULL) {
+        throw std::bad_alloc();
+    }
+    *static_cast<std::size_t*>(ptr) = n;
+    record_allocation(n);
+    return static_cast<unsigned char*>(ptr) + header_size;
+}
+
+void counted_delete(void* ptr) {
+    if (ptr) {
+        void* original = static_cast<unsigned char*>(ptr) - header_size;
+        record_release(*static_cast<std::size_t*>(original));
+        std::free(original);
+    }
+}
+
+}
+
+void* operator new(std::size_t n) { return counted_new(n); }
+void* operator new[](std::size_t n) { return counted_new(n); }
+void* operator new(std::size_t n, const std::nothrow_t&) noexcept { try { return counted_new(n); } catch (...) { return NULL; } }
+void* operator new[](std::size_t n, const std::nothrow_t&) noexcept { try { return counted_new(n); } catch (...) { return NULL; } }
+void operator delete(void* ptr) noexcept { counted_delete(ptr); }
+void operator delete[](void* ptr) noexcept { counted_delete(ptr); }
+void operator delete(void* ptr, std::size_t) noexcept { counted_delete(ptr); }
+void operator delete[](void* ptr, std::size_t) noexcept { counted_delete(ptr); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { counted_delete(ptr); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { counted_delete(ptr); }
+#endif
+
+struct AllocationSnapshot {
+    unsigned long long count;
+    unsigned long long bytes;
+    long long baseline;
+};
+
+// Resets the peak to the current usage, so that the peak after the scan reflects the heap usage of the scan itself.
+static AllocationSnapshot start_tracking() {
+    AllocationSnapshot snap;
+    snap.baseline = current_bytes.load();
+    peak_bytes.store(snap.baseline);
+    snap.count = num_allocations.load();
+    snap.bytes = allocated_bytes.load();
+    return snap;
+}
+
+/***************
+ *** Options ***
+ ***************/
+
+struct Options {
+    unsigned long long nlines = 1000000;
+    std::vector<int> threads { 1, 4 };
+    std::size_t buffer_size = 65536;
+    std::string csv;
+};
+
+static void usage(const char* prog) {
+    std::cerr << "Usage: " << prog << " [OPTIONS]\n"
+        << "  --nlines N            number of data lines in each generated file (default: 1000000)\n"
+        << "  --threads LIST        comma-separated number of threads (default: 1,4)\n"
+        << "  --buffer N            buffer size in bytes (default: 65536)\n"
+        << "  --csv PATH            write the results to a CSV file\n";
+}
+
+static Options parse_arguments(int argc, char* argv[]) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::runtime_error("missing value for '" + arg + "'");
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--nlines") {
+            opt.nlines = std::stoull(next());
+        } else if (arg == "--threads") {
+            opt.threads.clear();
+            std::stringstream stream(next());
+            std::string current;
+            while (std::getline(stream, current, ',')) {
+                if (!current.empty()) {
+                    opt.threads.push_back(std::stoi(current));
+                }
+            }
+        } else if (arg == "--buffer") {
+            opt.buffer_size = std::stoull(next());
+        } else if (arg == "--csv") {
+            opt.csv = next();
+        } else {
+            throw std::runtime_error("unknown argument '" + arg + "'");
+        }
+    }
+    return opt;
+}
+
+/****************
+ *** Scanning ***
+ ****************/
+
+struct Mode {
+    const char* name;
+    eminem::Format format;
+    eminem::Field field;
+};
+
+// Runs the scan method corresponding to each mode, returning the number of entries.
+template<class Parser_>
+unsigned long long scan_mode(Parser_& parser, const Mode& mode, double& checksum) {
+    parser.scan_preamble();
+    unsigned long long count = 0;
+    const std::string name = mode.name;
+
+    if (name == "integer" || name == "array_integer") {
+        parser.scan_integer([&](unsigned long long, unsigned long long, int v) -> void { checksum += v; ++count; });
+    } else if (name == "real" || name == "array_real") {
+        parser.scan_real([&](unsigned long long, unsigned long long, double v) -> void { checksum += v; ++count; });
+    } else if (name == "real_float") {
+        parser.template scan_real<float>([&](unsigned long long, unsigned long long, float v) -> void { checksum += v; ++count; });
+    } else if (name == "complex") {
+        parser.scan_complex([&](unsigned long long, unsigned long long, std::complex<double> v) -> void { checksum += v.real(); ++count; });
+    } else if (name == "pattern") {
+        parser.scan_pattern([&](unsigned long long r, unsigned long long, bool) -> void { checksum += r; ++count; });
+    } else {
+        parser.template scan_static<eminem::Object::MATRIX, eminem::Format::COORDINATE, eminem::Field::INTEGER>(
+            [&](unsigned long long, unsigned long long, int v) -> void { checksum += v; ++count; }
+        );
+    }
+
+    return count;
+}
+
+struct Result {
+    std::string mode;
+    int threads;
+    std::size_t bytes;
+    unsigned long long entries;
+    unsigned long long allocations;
+    unsigned long long allocated_bytes;
+    long long peak_heap;
+};
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    try {
+        opt = parse_arguments(argc, argv);
+    } catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        usage(argv[0]);
+        return 1;
+    }
+
+    const std::vector<Mode> modes {
+        { "integer", eminem::Format::COORDINATE, eminem::Field::INTEGER },
+        { "real", eminem::Format::COORDINATE, eminem::Field::REAL },
+        { "real_float", eminem::Format::COORDINATE, eminem::Field::REAL },
+        { "complex", eminem::Format::COORDINATE, eminem::Field::COMPLEX },
+        { "pattern", eminem::Format::COORDINATE, eminem::Field::PATTERN },
+        { "static", eminem::Format::COORDINATE, eminem::Field::INTEGER },
+        { "array_integer", eminem::Format::ARRAY, eminem::Field::INTEGER },
+        { "array_real", eminem::Format::ARRAY, eminem::Field::REAL }
+    };
+
+    std::vector<Result> results;
+    double checksum = 0;
+    for (const auto& mode : modes) {
+        GenerateOptions gen;
+        gen.format = mode.format;
+        gen.field = mode.field;
+        gen.nlines = opt.nlines;
+        if (gen.format == eminem::Format::ARRAY) {
+            gen.ncols = std::max(1ull, opt.nlines / gen.nrows);
+        }
+        const std::string contents = generate(gen);
+
+        for (auto threads : opt.threads) {
+            eminem::ParserOptions popt;
+            popt.num_threads = threads;
+            popt.buffer_size = opt.buffer_size;
+
+            // The whole lifetime of the parser is tracked, so the reported counts include the fixed costs of the buffers and thread pool.
+            auto run = [&]() -> unsigned long long {
+                auto parser = eminem::parse_text_buffer(reinterpret_cast<const unsigned char*>(contents.data()), contents.size(), popt);
+                return scan_mode(parser, mode, checksum);
+            };
+            run(); // warm-up to trigger any one-off allocations, e.g., in the standard library.
+
+            const auto snap = start_tracking();
+            Result res;
+            res.entries = run();
+            res.mode = mode.name;
+            res.threads = threads;
+            res.bytes = contents.size();
+            res.allocations = num_allocations.load() - snap.count;
+            res.allocated_bytes = allocated_bytes.load() - snap.bytes;
+            res.peak_heap = peak_bytes.load() - snap.baseline;
+            results.push_back(res);
+
+            const double mb = res.bytes / 1e6;
+            std::printf("%-14s threads=%-3d allocations=%-9llu (%.3g/MB) allocated=%.3g MB peak=%.3g MB\n",
+                res.mode.c_str(), threads, res.allocations, res.allocations / mb, res.allocated_bytes / 1e6, res.peak_heap / 1e6);
+        }
+    }
+
+    if (!opt.csv.empty()) {
+        std::ofstream handle(opt.csv);
+        handle << "mode,threads,buffer_size,bytes,entries,allocations,allocated_bytes,allocations_per_mb,peak_heap_bytes\n";
+        for (const auto& res : results) {
+            handle << res.mode << "," << res.threads << "," << opt.buffer_size << "," << res.bytes << "," << res.entries << ","
+                << res.allocations << "," << res.allocated_bytes << "," << res.allocations / (res.bytes / 1e6) << "," << res.peak_heap << "\n";
+        }
+    }
+
+    std::cout << "checksum: " << checksum << std::endl;
+    return 0;
+}
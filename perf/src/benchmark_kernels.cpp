@@ -0,0 +1,321 @@
+#include "benchmark/benchmark.h"
+
+#include "eminem/eminem.hpp"
+
+#include <string>
+#include <random>
+#include <cstdio>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <cstdint>
+#include <charconv>
+#include <functional>
+
+typedef eminem::Parser<std::unique_ptr<byteme::RawBufferReader> > BaseParser;
+
+// Exposing the parsing kernels so that they can be run directly on a pre-tokenized corpus, without any I/O or threading.
+// This struct is a friend of the Parser, which otherwise keeps the kernels private.
+namespace eminem {
+
+struct ParserKernelBenchmark {
+    template<bool last_, typename Integer_, typename Input2_, class Line_>
+    static auto scan_integer_field(bool size, Input2_& input, Line_ overall_line_count) {
+        return BaseParser::scan_integer_field<last_, Integer_>(size, input, overall_line_count);
+    }
+
+    template<bool last_, typename Type_, typename Input2_, class Line_>
+    static auto parse_real(Input2_& input, std::string& temporary, bool& all_integral, Line_ overall_line_count) {
+        return BaseParser::parse_real<last_, Type_>(input, temporary, all_integral, overall_line_count);
+    }
+
+    template<typename Type_>
+    using IntegerFieldParser = BaseParser::IntegerFieldParser<Type_>;
+
+    template<typename Type_>
+    using ComplexFieldParser = BaseParser::ComplexFieldParser<Type_>;
+};
+
+}
+
+typedef eminem::ParserKernelBenchmark Kernels;
+
+static constexpr int corpus_size = 1000000;
+
+// Each corpus consists of newline-terminated tokens, mimicking the last field of each line.
+static std::string build_corpus(std::function<std::string(std::mt19937_64&)> fun) {
+    std::mt19937_64 rng(42);
+    std::string output;
+    for (int i = 0; i < corpus_size; ++i) {
+        output += fun(rng);
+        output += '\n';
+    }
+    return output;
+}
+
+static std::string format_real(const char* format, double value) {
+    char buffer[64];
+    std::snprintf(buffer, sizeof(buffer), format, value);
+    return buffer;
+}
+
+static const std::string& index_corpus() {
+    static std::string corpus = build_corpus([](std::mt19937_64& rng) -> std::string { return std::to_string(rng() % 1000000 + 1); });
+    return corpus;
+}
+
+static const std::string& integer_corpus() {
+    static std::string corpus = build_corpus([](std::mt19937_64& rng) -> std::string { return std::to_string(static_cast<int>(rng() % 2001) - 1000); });
+    return corpus;
+}
+
+static const std::string& real_corpus(int style) {
+    static std::string corpora[4];
+    auto& corpus = corpora[style];
+    if (corpus.empty()) {
+        corpus = build_corpus([&](std::mt19937_64& rng) -> std::string {
+            std::normal_distribution<double> ndist;
+            switch (style) {
+                case 0: return format_real("%.4g", ndist(rng));
+                case 1: return format_real("%.17g", ndist(rng));
+                case 2: return format_real("%.6e", ndist(rng) * std::pow(10.0, static_cast<int>(rng() % 41) - 20));
+            }
+            static const char* specials[] = { "inf", "-inf", "nan", "Infinity", "-NaN", "1.5" };
+            return specials[rng() % 6];
+        });
+    }
+    return corpus;
+}
+
+static const char* real_style_name(int style) {
+    static const char* names[] = { "short", "long", "exponent", "special" };
+    return names[style];
+}
+
+static const std::string& complex_corpus() {
+    static std::string corpus = build_corpus([](std::mt19937_64& rng) -> std::string {
+        std::normal_distribution<double> ndist;
+        const double re = ndist(rng), im = ndist(rng);
+        return format_real("%.6g", re) + " " + format_real("%.6g", im);
+    });
+    return corpus;
+}
+
+static void set_rates(benchmark::State& state, const std::string& corpus) {
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * static_cast<std::int64_t>(corpus.size()));
+    state.SetItemsProcessed(static_cast<std::int64_t>(state.iterations()) * corpus_size);
+}
+
+/**********************
+ *** Integer fields ***
+ **********************/
+
+static void BM_scan_integer_field(benchmark::State& state) {
+    const auto& corpus = index_corpus();
+    for (auto _ : state) {
+        eminem::DirectBufferedReader input(corpus.data(), corpus.size());
+        std::uint64_t total = 0;
+        while (1) {
+            auto info = Kernels::scan_integer_field<true, std::uint64_t>(false, input, eminem::UntrackedLine());
+            total += info.index;
+            if (!info.remaining) {
+                break;
+            }
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    set_rates(state, corpus);
+}
+
+static void BM_IntegerFieldParser(benchmark::State& state) {
+    const auto& corpus = integer_corpus();
+    for (auto _ : state) {
+        eminem::DirectBufferedReader input(corpus.data(), corpus.size());
+        Kernels::IntegerFieldParser<int> parser;
+        long long total = 0;
+        while (1) {
+            auto info = parser(input, eminem::UntrackedLine());
+            total += info.value;
+            if (!info.remaining) {
+                break;
+            }
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    set_rates(state, corpus);
+}
+
+template<typename Integer_>
+static void run_strtoull(benchmark::State& state, const std::string& corpus) {
+    for (auto _ : state) {
+        const char* ptr = corpus.c_str();
+        const char* end = ptr + corpus.size();
+        Integer_ total = 0;
+        while (ptr < end) {
+            char* next;
+            if constexpr(std::is_signed<Integer_>::value) {
+                total += std::strtoll(ptr, &next, 10);
+            } else {
+                total += std::strtoull(ptr, &next, 10);
+            }
+            ptr = next + 1;
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    set_rates(state, corpus);
+}
+
+template<typename Integer_>
+static void run_from_chars_integer(benchmark::State& state, const std::string& corpus) {
+    for (auto _ : state) {
+        const char* ptr = corpus.data();
+        const char* end = ptr + corpus.size();
+        Integer_ total = 0;
+        while (ptr < end) {
+            Integer_ value = 0;
+            ptr = std::from_chars(ptr, end, value).ptr + 1;
+            total += value;
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    set_rates(state, corpus);
+}
+
+static void BM_index_strtoull(benchmark::State& state) {
+    run_strtoull<std::uint64_t>(state, index_corpus());
+}
+
+static void BM_index_from_chars(benchmark::State& state) {
+    run_from_chars_integer<std::uint64_t>(state, index_corpus());
+}
+
+static void BM_integer_strtoll(benchmark::State& state) {
+    run_strtoull<long long>(state, integer_corpus());
+}
+
+static void BM_integer_from_chars(benchmark::State& state) {
+    run_from_chars_integer<long long>(state, integer_corpus());
+}
+
+/*******************
+ *** Real fields ***
+ *******************/
+
+static void BM_parse_real(benchmark::State& state) {
+    const auto& corpus = real_corpus(state.range(0));
+    state.SetLabel(real_style_name(state.range(0)));
+    for (auto _ : state) {
+        eminem::DirectBufferedReader input(corpus.data(), corpus.size());
+        std::string temporary;
+        bool all_integral = true;
+        double total = 0;
+        while (1) {
+            auto info = Kernels::parse_real<true, double>(input, temporary, all_integral, eminem::UntrackedLine());
+            total += info.value;
+            if (!info.remaining) {
+                break;
+            }
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    set_rates(state, corpus);
+}
+
+static void BM_strtod(benchmark::State& state) {
+    const auto& corpus = real_corpus(state.range(0));
+    state.SetLabel(real_style_name(state.range(0)));
+    for (auto _ : state) {
+        const char* ptr = corpus.c_str();
+        const char* end = ptr + corpus.size();
+        double total = 0;
+        while (ptr < end) {
+            char* next;
+            total += std::strtod(ptr, &next);
+            ptr = next + 1;
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    set_rates(state, corpus);
+}
+
+#ifdef __cpp_lib_to_chars
+static void BM_from_chars_real(benchmark::State& state) {
+    const auto& corpus = real_corpus(state.range(0));
+    state.SetLabel(real_style_name(state.range(0)));
+    for (auto _ : state) {
+        const char* ptr = corpus.data();
+        const char* end = ptr + corpus.size();
+        double total = 0;
+        while (ptr < end) {
+            // Skipping the infinity/NaN signs that from_chars() doesn't handle, to keep the comparison going.
+            double value = 0;
+            auto res = std::from_chars(ptr, end, value);
+            if (res.ec != std::errc()) {
+                res.ptr = static_cast<const char*>(std::memchr(ptr, '\n', end - ptr));
+            }
+            ptr = res.ptr + 1;
+            total += value;
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    set_rates(state, corpus);
+}
+#endif
+
+/**********************
+ *** Complex fields ***
+ **********************/
+
+static void BM_ComplexFieldParser(benchmark::State& state) {
+    const auto& corpus = complex_corpus();
+    for (auto _ : state) {
+        eminem::DirectBufferedReader input(corpus.data(), corpus.size());
+        Kernels::ComplexFieldParser<double> parser;
+        double total = 0;
+        while (1) {
+            auto info = parser(input, eminem::UntrackedLine());
+            total += info.value.real() + info.value.imag();
+            if (!info.remaining) {
+                break;
+            }
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    set_rates(state, corpus);
+}
+
+static void BM_complex_strtod(benchmark::State& state) {
+    const auto& corpus = complex_corpus();
+    for (auto _ : state) {
+        const char* ptr = corpus.c_str();
+        const char* end = ptr + corpus.size();
+        double total = 0;
+        while (ptr < end) {
+            char* next;
+            total += std::strtod(ptr, &next);
+            total += std::strtod(next + 1, &next);
+            ptr = next + 1;
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    set_rates(state, corpus);
+}
+
+BENCHMARK(BM_scan_integer_field);
+BENCHMARK(BM_index_strtoull);
+BENCHMARK(BM_index_from_chars);
+
+BENCHMARK(BM_IntegerFieldParser);
+BENCHMARK(BM_integer_strtoll);
+BENCHMARK(BM_integer_from_chars);
+
+BENCHMARK(BM_parse_real)->DenseRange(0, 3);
+BENCHMARK(BM_strtod)->DenseRange(0, 3);
+#ifdef __cpp_lib_to_chars
+BENCHMARK(BM_from_chars_real)->DenseRange(0, 3);
+#endif
+
+BENCHMARK(BM_ComplexFieldParser);
+BENCHMARK(BM_complex_strtod);
+
+BENCHMARK_MAIN();
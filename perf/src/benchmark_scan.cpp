@@ -0,0 +1,96 @@
+#include "benchmark/benchmark.h"
+
+#include "eminem/eminem.hpp"
+#include "generate.h"
+
+#include <map>
+#include <tuple>
+#include <string>
+#include <vector>
+
+// Caching the generated inputs so that each combination is only simulated once across all thread/buffer settings.
+static const std::string& get_input(eminem::Object object, eminem::Format format, eminem::Field field) {
+    static std::map<std::tuple<eminem::Object, eminem::Format, eminem::Field>, std::string> cache;
+    auto key = std::make_tuple(object, format, field);
+    auto it = cache.find(key);
+    if (it != cache.end()) {
+        return it->second;
+    }
+
+    GenerateOptions opt;
+    opt.object = object;
+    opt.format = format;
+    opt.field = field;
+    if (format == eminem::Format::ARRAY) {
+        if (object == eminem::Object::MATRIX) {
+            opt.nrows = 1000;
+            opt.ncols = 1000;
+        } else {
+            opt.nrows = 1000000;
+        }
+    } else if (object == eminem::Object::VECTOR) {
+        opt.nrows = 10000000;
+    }
+
+    return cache.emplace(key, generate(opt)).first->second;
+}
+
+static void scan_input(benchmark::State& state, eminem::Object object, eminem::Format format, eminem::Field field) {
+    const auto& input = get_input(object, format, field);
+    eminem::ParserOptions opt;
+    opt.num_threads = state.range(0);
+    opt.buffer_size = state.range(1);
+
+    eminem::LineIndex nlines = 0;
+    for (auto _ : state) {
+        auto parser = eminem::parse_text_buffer(reinterpret_cast<const unsigned char*>(input.data()), input.size(), opt);
+        parser.scan_preamble();
+        nlines = parser.get_nlines();
+
+        double total = 0;
+        if (field == eminem::Field::INTEGER) {
+            parser.scan_integer([&](unsigned long long, unsigned long long, int v) -> void { total += v; });
+        } else if (field == eminem::Field::REAL) {
+            parser.scan_real([&](unsigned long long, unsigned long long, double v) -> void { total += v; });
+        } else if (field == eminem::Field::COMPLEX) {
+            parser.scan_complex([&](unsigned long long, unsigned long long, std::complex<double> v) -> void { total += v.real(); });
+        } else {
+            parser.scan_pattern([&](unsigned long long r, unsigned long long, bool) -> void { total += r; });
+        }
+        benchmark::DoNotOptimize(total);
+    }
+
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations()) * static_cast<std::int64_t>(input.size()));
+    state.counters["entries"] = benchmark::Counter(static_cast<double>(state.iterations()) * static_cast<double>(nlines), benchmark::Counter::kIsRate);
+}
+
+int main(int argc, char** argv) {
+    const std::vector<eminem::Object> objects { eminem::Object::MATRIX, eminem::Object::VECTOR };
+    const std::vector<eminem::Format> formats { eminem::Format::COORDINATE, eminem::Format::ARRAY };
+    const std::vector<eminem::Field> fields { eminem::Field::INTEGER, eminem::Field::REAL, eminem::Field::COMPLEX, eminem::Field::PATTERN };
+
+    for (auto object : objects) {
+        for (auto format : formats) {
+            for (auto field : fields) {
+                if (format == eminem::Format::ARRAY && field == eminem::Field::PATTERN) {
+                    continue; // not allowed by the Matrix Market format.
+                }
+
+                std::string name = std::string("scan/") + object_name(object) + "/" + format_name(format) + "/" + field_name(field);
+                benchmark::RegisterBenchmark(name.c_str(), scan_input, object, format, field)
+                    ->ArgNames({ "threads", "buffer" })
+                    ->ArgsProduct({ { 1, 2, 4 }, { 65536, 1 << 20 } })
+                    ->Unit(benchmark::kMillisecond)
+                    ->UseRealTime();
+            }
+        }
+    }
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
@@ -0,0 +1,180 @@
+#ifndef EMINEM_PERF_COUNTERS_H
+#define EMINEM_PERF_COUNTERS_H
+
+#include "eminem/ParserStats.hpp"
+
+#include <array>
+#include <string>
+#include <mutex>
+#include <cstdint>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+// Hardware performance counters via Linux's perf_event_open(), counting the calling thread only.
+// If the counters are not available (e.g., non-Linux systems, restrictive perf_event_paranoid settings, virtual machines without a PMU),
+// the affected events are simply reported as unavailable.
+class HardwareCounters {
+public:
+    enum Event { CYCLES, INSTRUCTIONS, BRANCHES, BRANCH_MISSES, L1D_MISSES, LLC_MISSES, NUM_EVENTS };
+
+    static const char* event_name(int e) {
+        static const char* names[] = { "cycles", "instructions", "branches", "branch_misses", "l1d_misses", "llc_misses" };
+        return names[e];
+    }
+
+    struct Counts {
+        std::array<double, NUM_EVENTS> values{};
+        std::array<bool, NUM_EVENTS> available{};
+
+        void add(const Counts& other) {
+            for (int e = 0; e < NUM_EVENTS; ++e) {
+                values[e] += other.values[e];
+                available[e] = available[e] || other.available[e];
+            }
+        }
+    };
+
+    // Raw readings of the counters, which are differenced between two points in time to obtain the counts in between.
+    struct Snapshot {
+        std::array<std::uint64_t, NUM_EVENTS> value{};
+        std::array<std::uint64_t, NUM_EVENTS> enabled{};
+        std::array<std::uint64_t, NUM_EVENTS> running{};
+    };
+
+public:
+    // Counting starts immediately and continues until destruction, so that each phase only needs to read the counters.
+    HardwareCounters() {
+        my_fds.fill(-1);
+#ifdef __linux__
+        const std::uint64_t l1d = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        const std::array<std::pair<std::uint32_t, std::uint64_t>, NUM_EVENTS> configs {{
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_INSTRUCTIONS },
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+            { PERF_TYPE_HW_CACHE, l1d },
+            { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES }
+        }};
+
+        for (int e = 0; e < NUM_EVENTS; ++e) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = configs[e].first;
+            attr.config = configs[e].second;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            my_fds[e] = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+            if (my_fds[e] >= 0) {
+                my_any = true;
+            }
+        }
+#endif
+    }
+
+    ~HardwareCounters() {
+#ifdef __linux__
+        for (auto fd : my_fds) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    HardwareCounters(const HardwareCounters&) = delete;
+    HardwareCounters& operator=(const HardwareCounters&) = delete;
+
+    bool any_available() const {
+        return my_any;
+    }
+
+    void read(Snapshot& output) const {
+#ifdef __linux__
+        for (int e = 0; e < NUM_EVENTS; ++e) {
+            if (my_fds[e] < 0) {
+                continue;
+            }
+            std::uint64_t buffer[3];
+            if (::read(my_fds[e], buffer, sizeof(buffer)) == static_cast<ssize_t>(sizeof(buffer))) {
+                output.value[e] = buffer[0];
+                output.enabled[e] = buffer[1];
+                output.running[e] = buffer[2];
+            }
+        }
+#else
+        (void)output;
+#endif
+    }
+
+    // Adds the counts between 'start' and 'end' to 'output', scaling for any multiplexing of the counters.
+    static void accumulate(const Snapshot& start, const Snapshot& end, Counts& output) {
+        for (int e = 0; e < NUM_EVENTS; ++e) {
+            const auto running = end.running[e] - start.running[e];
+            if (running == 0) {
+                continue; // never scheduled, e.g., because the PMU is oversubscribed or the counter is not available.
+            }
+            const auto enabled = end.enabled[e] - start.enabled[e];
+            output.values[e] += static_cast<double>(end.value[e] - start.value[e]) * static_cast<double>(enabled) / static_cast<double>(running);
+            output.available[e] = true;
+        }
+    }
+
+private:
+    std::array<int, NUM_EVENTS> my_fds;
+    bool my_any = false;
+};
+
+// Statistics policy for the eminem::Parser that collects the hardware counters for each phase of the scan.
+// Each thread opens its own counters on its first phase, which are read at the start and end of each phase on that thread.
+// The counts for each phase are then summed across all threads, e.g., the parsing phase is summed across all workers.
+struct PhaseCounterStats : public eminem::ParserStats {
+    static constexpr int num_phases = 5; // one for each eminem::ParserPhase.
+    std::array<HardwareCounters::Counts, num_phases> counts;
+
+    void start_phase(eminem::ParserPhase phase) {
+        if (phase == eminem::ParserPhase::SCAN) {
+            counts = decltype(counts)();
+        }
+        auto& local = thread_counters();
+        local.counters.read(local.starts[static_cast<int>(phase)]);
+    }
+
+    void end_phase(eminem::ParserPhase phase) {
+        auto& local = thread_counters();
+        HardwareCounters::Snapshot end;
+        local.counters.read(end);
+        const auto p = static_cast<int>(phase);
+        std::lock_guard lck(mutex());
+        HardwareCounters::accumulate(local.starts[p], end, counts[p]);
+    }
+
+    const HardwareCounters::Counts& get(eminem::ParserPhase phase) const {
+        return counts[static_cast<int>(phase)];
+    }
+
+private:
+    struct ThreadCounters {
+        HardwareCounters counters;
+        std::array<HardwareCounters::Snapshot, num_phases> starts;
+    };
+
+    static ThreadCounters& thread_counters() {
+        thread_local ThreadCounters local;
+        return local;
+    }
+
+    static std::mutex& mutex() {
+        static std::mutex mut;
+        return mut;
+    }
+};
+
+#endif
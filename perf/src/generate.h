@@ -0,0 +1,110 @@
+#ifndef EMINEM_PERF_GENERATE_H
+#define EMINEM_PERF_GENERATE_H
+
+#include "eminem/eminem.hpp"
+
+#include <string>
+#include <random>
+#include <cstdio>
+
+// In-memory Matrix Market files for the benchmarks, using single-space separators as in most production files.
+struct GenerateOptions {
+    eminem::Object object = eminem::Object::MATRIX;
+    eminem::Format format = eminem::Format::COORDINATE;
+    eminem::Field field = eminem::Field::INTEGER;
+    unsigned long long nrows = 100000;
+    unsigned long long ncols = 10000;
+    unsigned long long nlines = 1000000; // only used for coordinate formats.
+    unsigned long long seed = 42;
+};
+
+inline const char* object_name(eminem::Object object) {
+    return (object == eminem::Object::MATRIX ? "matrix" : "vector");
+}
+
+inline const char* format_name(eminem::Format format) {
+    return (format == eminem::Format::COORDINATE ? "coordinate" : "array");
+}
+
+inline const char* field_name(eminem::Field field) {
+    switch (field) {
+        case eminem::Field::INTEGER: return "integer";
+        case eminem::Field::REAL: return "real";
+        case eminem::Field::DOUBLE: return "double";
+        case eminem::Field::COMPLEX: return "complex";
+        default: return "pattern";
+    }
+}
+
+// Appends the value(s) of a single line, preceded by a separator if 'leading' is true.
+template<class Rng_>
+void append_value(std::string& output, eminem::Field field, Rng_& rng, bool leading) {
+    if (field == eminem::Field::PATTERN) {
+        return;
+    }
+    if (leading) {
+        output += ' ';
+    }
+
+    char buffer[64];
+    if (field == eminem::Field::INTEGER) {
+        output += std::to_string(rng() % 100 + 1); // small counts, as in single-cell data.
+    } else if (field == eminem::Field::COMPLEX) {
+        std::normal_distribution<double> ndist;
+        const double re = ndist(rng), im = ndist(rng);
+        std::snprintf(buffer, sizeof(buffer), "%.6g %.6g", re, im);
+        output += buffer;
+    } else {
+        std::normal_distribution<double> ndist;
+        std::snprintf(buffer, sizeof(buffer), "%.6g", ndist(rng));
+        output += buffer;
+    }
+}
+
+inline std::string generate(const GenerateOptions& options) {
+    std::mt19937_64 rng(options.seed);
+    const bool is_vector = (options.object == eminem::Object::VECTOR);
+    const bool is_coordinate = (options.format == eminem::Format::COORDINATE);
+
+    std::string output = "%%MatrixMarket ";
+    output += object_name(options.object);
+    output += " ";
+    output += format_name(options.format);
+    output += " ";
+    output += field_name(options.field);
+    if (!is_vector) {
+        output += " general";
+    }
+    output += "\n";
+
+    output += std::to_string(options.nrows);
+    if (!is_vector) {
+        output += " " + std::to_string(options.ncols);
+    }
+    if (is_coordinate) {
+        output += " " + std::to_string(options.nlines);
+    }
+    output += "\n";
+
+    if (is_coordinate) {
+        for (unsigned long long i = 0; i < options.nlines; ++i) {
+            output += std::to_string(rng() % options.nrows + 1);
+            if (!is_vector) {
+                output += ' ';
+                output += std::to_string(rng() % options.ncols + 1);
+            }
+            append_value(output, options.field, rng, true);
+            output += '\n';
+        }
+    } else {
+        const unsigned long long total = options.nrows * (is_vector ? 1 : options.ncols);
+        for (unsigned long long i = 0; i < total; ++i) {
+            append_value(output, options.field, rng, false);
+            output += '\n';
+        }
+    }
+
+    return output;
+}
+
+#endif
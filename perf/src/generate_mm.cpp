@@ -0,0 +1,453 @@
+#include "zlib.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <unordered_set>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <stdexcept>
+#include <cstdio>
+#include <cstdint>
+#include <cmath>
+
+// Streams a synthetic coordinate matrix to disk, optionally Gzip-compressed, using multiple threads.
+// The file is divided into blocks of consecutive columns; each block is formatted (and compressed) independently,
+// with its own random seed, so the output only depends on the options and not on the number of threads.
+
+struct Options {
+    std::string output;
+    bool gzip = false;
+    int level = 6;
+
+    std::string field = "integer";
+    unsigned long long nrows = 10000;
+    unsigned long long ncols = 10000;
+    double density = 0.01;
+
+    std::string order = "sorted"; // sorted, shuffled or skewed.
+    double skew = 0.5; // exponent of the cumulative column distribution for skewed order.
+    std::string values = "small"; // small, long or exponent.
+
+    double comments = 0; // probability of a comment line before each data line.
+    double noise = 0; // probability of irregular whitespace in each data line.
+    bool crlf = false;
+
+    unsigned long long seed = 42;
+    int num_threads = 1;
+    unsigned long long block_lines = 1000000;
+};
+
+static void usage(const char* prog) {
+    std::cerr << "Usage: " << prog << " --output PATH [OPTIONS]\n"
+        << "  --gzip                compress the output (default: true if PATH ends in .gz)\n"
+        << "  --level N             compression level (default: 6)\n"
+        << "  --field TYPE          integer, real, complex or pattern (default: integer)\n"
+        << "  --nrows N             number of rows (default: 10000)\n"
+        << "  --ncols N             number of columns (default: 10000)\n"
+        << "  --density X           fraction of non-zero entries (default: 0.01)\n"
+        << "  --order TYPE          sorted, shuffled or skewed (default: sorted)\n"
+        << "  --skew X              exponent for skewed column sizes, in (0, 1] (default: 0.5)\n"
+        << "  --values TYPE         small, long or exponent (default: small)\n"
+        << "  --comments X          probability of a comment before each line (default: 0)\n"
+        << "  --noise X             probability of irregular whitespace in each line (default: 0)\n"
+        << "  --crlf                use CRLF line endings\n"
+        << "  --seed N              random seed (default: 42)\n"
+        << "  --threads N           number of threads (default: 1)\n"
+        << "  --block-lines N       approximate number of lines in each block (default: 1000000)\n";
+}
+
+static Options parse_arguments(int argc, char* argv[]) {
+    Options opt;
+    bool gzip_set = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::runtime_error("missing value for '" + arg + "'");
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--output") {
+            opt.output = next();
+        } else if (arg == "--gzip") {
+            opt.gzip = true;
+            gzip_set = true;
+        } else if (arg == "--level") {
+            opt.level = std::stoi(next());
+        } else if (arg == "--field") {
+            opt.field = next();
+        } else if (arg == "--nrows") {
+            opt.nrows = std::stoull(next());
+        } else if (arg == "--ncols") {
+            opt.ncols = std::stoull(next());
+        } else if (arg == "--density") {
+            opt.density = std::stod(next());
+        } else if (arg == "--order") {
+            opt.order = next();
+        } else if (arg == "--skew") {
+            opt.skew = std::stod(next());
+        } else if (arg == "--values") {
+            opt.values = next();
+        } else if (arg == "--comments") {
+            opt.comments = std::stod(next());
+        } else if (arg == "--noise") {
+            opt.noise = std::stod(next());
+        } else if (arg == "--crlf") {
+            opt.crlf = true;
+        } else if (arg == "--seed") {
+            opt.seed = std::stoull(next());
+        } else if (arg == "--threads") {
+            opt.num_threads = std::stoi(next());
+        } else if (arg == "--block-lines") {
+            opt.block_lines = std::stoull(next());
+        } else {
+            throw std::runtime_error("unknown argument '" + arg + "'");
+        }
+    }
+
+    if (opt.output.empty()) {
+        throw std::runtime_error("'--output' must be specified");
+    }
+    if (!gzip_set && opt.output.size() > 3 && opt.output.compare(opt.output.size() - 3, 3, ".gz") == 0) {
+        opt.gzip = true;
+    }
+    if (opt.field != "integer" && opt.field != "real" && opt.field != "complex" && opt.field != "pattern") {
+        throw std::runtime_error("unknown field '" + opt.field + "'");
+    }
+    if (opt.order != "sorted" && opt.order != "shuffled" && opt.order != "skewed") {
+        throw std::runtime_error("unknown order '" + opt.order + "'");
+    }
+    if (opt.values != "small" && opt.values != "long" && opt.values != "exponent") {
+        throw std::runtime_error("unknown value style '" + opt.values + "'");
+    }
+    if (opt.field == "integer" && opt.values == "exponent") {
+        throw std::runtime_error("exponent values are not supported for integer fields");
+    }
+    if (opt.nrows == 0 || opt.ncols == 0) {
+        throw std::runtime_error("number of rows and columns should be positive");
+    }
+    if (opt.skew <= 0 || opt.skew > 1) {
+        throw std::runtime_error("'--skew' should lie in (0, 1]");
+    }
+    opt.num_threads = std::max(1, opt.num_threads);
+    opt.block_lines = std::max(1ull, opt.block_lines);
+    return opt;
+}
+
+/******************************
+ *** Column and block sizes ***
+ ******************************/
+
+// Number of entries in each column, such that the total is (approximately) equal to density * nrows * ncols.
+// For skewed order, the cumulative number of entries up to column 'c' is proportional to '(c / ncols)^skew',
+// so the earlier columns are much larger; each column is capped at the number of rows.
+static std::vector<unsigned long long> compute_column_sizes(const Options& opt) {
+    const double total = std::round(opt.density * static_cast<double>(opt.nrows) * static_cast<double>(opt.ncols));
+    const double exponent = (opt.order == "skewed" ? opt.skew : 1.0);
+
+    std::vector<unsigned long long> sizes(opt.ncols);
+    unsigned long long previous = 0;
+    for (unsigned long long c = 0; c < opt.ncols; ++c) {
+        const double frac = std::pow(static_cast<double>(c + 1) / static_cast<double>(opt.ncols), exponent);
+        const auto cumulative = static_cast<unsigned long long>(std::round(total * frac));
+        sizes[c] = std::min(cumulative - previous, opt.nrows);
+        previous = cumulative;
+    }
+    return sizes;
+}
+
+struct Block {
+    unsigned long long start_column;
+    unsigned long long end_column;
+};
+
+static std::vector<Block> compute_blocks(const std::vector<unsigned long long>& sizes, unsigned long long block_lines) {
+    std::vector<Block> blocks;
+    unsigned long long start = 0, accumulated = 0;
+    for (unsigned long long c = 0; c < sizes.size(); ++c) {
+        accumulated += sizes[c];
+        if (accumulated >= block_lines) {
+            blocks.push_back(Block{ start, c + 1 });
+            start = c + 1;
+            accumulated = 0;
+        }
+    }
+    if (start < sizes.size()) {
+        blocks.push_back(Block{ start, sizes.size() });
+    }
+    return blocks;
+}
+
+/*************************
+ *** Formatting blocks ***
+ *************************/
+
+// Floyd's algorithm for sampling 'k' distinct rows without replacement, returned in sorted order.
+template<class Rng_>
+void sample_rows(unsigned long long nrows, unsigned long long k, Rng_& rng, std::vector<unsigned long long>& output) {
+    output.clear();
+    if (k == nrows) {
+        for (unsigned long long r = 0; r < nrows; ++r) {
+            output.push_back(r);
+        }
+        return;
+    }
+
+    std::unordered_set<unsigned long long> chosen;
+    for (unsigned long long j = nrows - k; j < nrows; ++j) {
+        const auto t = std::uniform_int_distribution<unsigned long long>(0, j)(rng);
+        if (chosen.insert(t).second) {
+            output.push_back(t);
+        } else {
+            chosen.insert(j);
+            output.push_back(j);
+        }
+    }
+    std::sort(output.begin(), output.end());
+}
+
+template<class Rng_>
+void append_real(std::string& output, const std::string& style, Rng_& rng) {
+    char buffer[64];
+    std::normal_distribution<double> ndist;
+    if (style == "small") {
+        // Count-like values that happen to be stored as reals.
+        output += std::to_string(std::geometric_distribution<int>(0.3)(rng) + 1);
+        return;
+    } else if (style == "long") {
+        std::snprintf(buffer, sizeof(buffer), "%.17g", ndist(rng));
+    } else {
+        std::snprintf(buffer, sizeof(buffer), "%.6e", ndist(rng) * std::pow(10.0, std::uniform_int_distribution<int>(-30, 30)(rng)));
+    }
+    output += buffer;
+}
+
+template<class Rng_>
+void append_integer(std::string& output, const std::string& style, Rng_& rng) {
+    if (style == "small") {
+        output += std::to_string(std::geometric_distribution<int>(0.3)(rng) + 1);
+    } else {
+        output += std::to_string(std::uniform_int_distribution<long long>(-1000000000, 1000000000)(rng));
+    }
+}
+
+static std::string format_block(const Options& opt, const std::vector<unsigned long long>& sizes, const Block& block, unsigned long long index) {
+    std::seed_seq seq{ opt.seed, static_cast<unsigned long long>(index) };
+    std::mt19937_64 rng(seq);
+    std::uniform_real_distribution<double> unif;
+    const char* newline = (opt.crlf ? "\r\n" : "\n");
+
+    std::vector<std::string> lines;
+    std::vector<unsigned long long> rows;
+    for (auto c = block.start_column; c < block.end_column; ++c) {
+        sample_rows(opt.nrows, sizes[c], rng, rows);
+        const auto col_str = std::to_string(c + 1);
+
+        for (auto r : rows) {
+            std::string line;
+            if (opt.comments > 0 && unif(rng) < opt.comments) {
+                line += "% synthetic comment";
+                line += newline;
+            }
+
+            std::string sep = " ";
+            bool trailing = false;
+            if (opt.noise > 0 && unif(rng) < opt.noise) {
+                switch (rng() % 3) {
+                    case 0: sep = "  "; break;
+                    case 1: sep = "\t"; break;
+                    default: trailing = true;
+                }
+            }
+
+            line += std::to_string(r + 1);
+            line += sep;
+            line += col_str;
+            if (opt.field == "integer") {
+                line += sep;
+                append_integer(line, opt.values, rng);
+            } else if (opt.field == "real") {
+                line += sep;
+                append_real(line, opt.values, rng);
+            } else if (opt.field == "complex") {
+                line += sep;
+                append_real(line, opt.values, rng);
+                line += sep;
+                append_real(line, opt.values, rng);
+            }
+
+            if (trailing) {
+                line += ' ';
+            }
+            line += newline;
+            lines.push_back(std::move(line));
+        }
+    }
+
+    // Shuffling within each block, which is the best we can do without holding the entire file in memory.
+    if (opt.order == "shuffled") {
+        std::shuffle(lines.begin(), lines.end(), rng);
+    }
+
+    std::string output;
+    for (const auto& line : lines) {
+        output += line;
+    }
+    return output;
+}
+
+// Each block is compressed as a separate Gzip member; concatenated members form a valid Gzip file.
+static std::string compress(const std::string& input, int level) {
+    z_stream strm{};
+    if (deflateInit2(&strm, level, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        throw std::runtime_error("failed to initialize the Gzip compressor");
+    }
+
+    std::string output(deflateBound(&strm, input.size()), '\0');
+    strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+    strm.avail_in = input.size();
+    strm.next_out = reinterpret_cast<Bytef*>(output.data());
+    strm.avail_out = output.size();
+    const int status = deflate(&strm, Z_FINISH);
+    deflateEnd(&strm);
+    if (status != Z_STREAM_END) {
+        throw std::runtime_error("failed to compress a block");
+    }
+
+    output.resize(output.size() - strm.avail_out);
+    return output;
+}
+
+/***************************
+ *** Writing in parallel ***
+ ***************************/
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    try {
+        opt = parse_arguments(argc, argv);
+    } catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        usage(argv[0]);
+        return 1;
+    }
+
+    const auto sizes = compute_column_sizes(opt);
+    unsigned long long nlines = 0;
+    for (auto s : sizes) {
+        nlines += s;
+    }
+    const auto blocks = compute_blocks(sizes, opt.block_lines);
+
+    std::FILE* handle = std::fopen(opt.output.c_str(), "wb");
+    if (handle == NULL) {
+        std::cerr << "failed to open '" << opt.output << "'" << std::endl;
+        return 1;
+    }
+
+    auto write = [&](const std::string& contents) -> void {
+        if (std::fwrite(contents.data(), 1, contents.size(), handle) != contents.size()) {
+            throw std::runtime_error("failed to write to '" + opt.output + "'");
+        }
+    };
+
+    const char* newline = (opt.crlf ? "\r\n" : "\n");
+    std::string preamble = "%%MatrixMarket matrix coordinate " + opt.field + " general" + newline;
+    preamble += std::to_string(opt.nrows) + " " + std::to_string(opt.ncols) + " " + std::to_string(nlines) + newline;
+    write(opt.gzip ? compress(preamble, opt.level) : preamble);
+
+    // Workers claim blocks in order and fill a window of slots, which the main thread writes out in order.
+    // The window limits the number of blocks held in memory at any given time.
+    const std::size_t window = 2 * static_cast<std::size_t>(opt.num_threads);
+    std::vector<std::string> slots(window);
+    std::vector<char> ready(window, false);
+    std::size_t next_block = 0, written = 0;
+    std::mutex mut;
+    std::condition_variable cv;
+    std::atomic<bool> failed(false);
+    std::string error;
+
+    auto worker = [&]() -> void {
+        while (1) {
+            std::size_t b;
+            {
+                std::unique_lock lck(mut);
+                cv.wait(lck, [&]() -> bool { return failed || next_block >= blocks.size() || next_block < written + window; });
+                if (failed || next_block >= blocks.size()) {
+                    return;
+                }
+                b = next_block++;
+            }
+
+            std::string contents;
+            try {
+                contents = format_block(opt, sizes, blocks[b], b);
+                if (opt.gzip) {
+                    contents = compress(contents, opt.level);
+                }
+            } catch (std::exception& e) {
+                std::lock_guard lck(mut);
+                error = e.what();
+                failed = true;
+                cv.notify_all();
+                return;
+            }
+
+            std::lock_guard lck(mut);
+            slots[b % window] = std::move(contents);
+            ready[b % window] = true;
+            cv.notify_all();
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(opt.num_threads);
+    for (int t = 0; t < opt.num_threads; ++t) {
+        threads.emplace_back(worker);
+    }
+
+    try {
+        for (std::size_t b = 0; b < blocks.size(); ++b) {
+            std::string contents;
+            {
+                std::unique_lock lck(mut);
+                cv.wait(lck, [&]() -> bool { return failed || ready[b % window]; });
+                if (failed) {
+                    break;
+                }
+                contents.swap(slots[b % window]);
+                ready[b % window] = false;
+            }
+
+            write(contents);
+
+            std::lock_guard lck(mut);
+            ++written;
+            cv.notify_all();
+        }
+    } catch (std::exception& e) {
+        std::lock_guard lck(mut);
+        error = e.what();
+        failed = true;
+        cv.notify_all();
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+    std::fclose(handle);
+
+    if (failed) {
+        std::cerr << error << std::endl;
+        return 1;
+    }
+
+    std::cout << "wrote " << nlines << " lines in " << blocks.size() << " blocks to '" << opt.output << "'" << std::endl;
+    return 0;
+}
@@ -0,0 +1,68 @@
+#include "eminem/eminem.hpp"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include <cstdlib>
+
+// Compares the generic scan_integer() against the specialized scan_static() for an integer coordinate matrix.
+int main(int argc, char* argv[]) {
+    unsigned long long nlines = 5000000;
+    if (argc > 1) {
+        nlines = std::strtoull(argv[1], NULL, 10);
+    }
+    int reps = 5;
+    if (argc > 2) {
+        reps = std::atoi(argv[2]);
+    }
+
+    const int NR = 30000, NC = 10000;
+    std::mt19937_64 rng(1234567);
+    std::string contents = "%%MatrixMarket matrix coordinate integer general\n" + std::to_string(NR) + " " + std::to_string(NC) + " " + std::to_string(nlines) + "\n";
+    for (unsigned long long i = 0; i < nlines; ++i) {
+        contents += std::to_string(rng() % NR + 1);
+        contents += ' ';
+        contents += std::to_string(rng() % NC + 1);
+        contents += ' ';
+        contents += std::to_string(rng() % 20 + 1);
+        contents += '\n';
+    }
+
+    auto run = [&](bool specialized) -> double {
+        auto start = std::chrono::steady_clock::now();
+        auto parser = eminem::parse_text_buffer(reinterpret_cast<const unsigned char*>(contents.data()), contents.size(), {});
+        parser.scan_preamble();
+        unsigned long long total = 0;
+        auto store = [&](unsigned long long r, unsigned long long c, int v) -> void {
+            total += r + c + v;
+        };
+        if (specialized) {
+            parser.template scan_static<eminem::Object::MATRIX, eminem::Format::COORDINATE, eminem::Field::INTEGER>(store);
+        } else {
+            parser.scan_integer(store);
+        }
+        auto end = std::chrono::steady_clock::now();
+        if (total == 0) {
+            std::cerr << "unexpected zero total" << std::endl;
+        }
+        return std::chrono::duration<double>(end - start).count();
+    };
+
+    std::vector<double> generic, specialized;
+    for (int r = 0; r < reps; ++r) {
+        generic.push_back(run(false));
+        specialized.push_back(run(true));
+    }
+
+    auto report = [&](const std::string& name, std::vector<double>& timings) -> void {
+        std::sort(timings.begin(), timings.end());
+        double median = timings[timings.size() / 2];
+        std::cout << name << ": " << median * 1000 << " ms (median), " << contents.size() / median / 1e6 << " MB/s" << std::endl;
+    };
+    report("generic", generic);
+    report("specialized", specialized);
+    return 0;
+}
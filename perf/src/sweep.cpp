@@ -0,0 +1,588 @@
+#include "eminem/eminem.hpp"
+#include "generate.h"
+#include "counters.h"
+
+#include "zlib.h"
+
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <filesystem>
+#include <stdexcept>
+#include <cstdio>
+#include <cmath>
+#include <array>
+#include <limits>
+#include <memory>
+#include <type_traits>
+
+// Sweeps the number of threads, buffer size and reader backend for scanning a single Matrix Market file,
+// reporting the median time across repetitions of each combination.
+
+struct Options {
+    std::string file;
+    std::string generate; // alternative to 'file', as 'object/format/field[:nlines]'.
+    std::vector<int> threads;
+    std::vector<std::size_t> buffers { 16384, 65536, 262144, 1048576, 4194304, 16777216 };
+    std::vector<std::string> backends { "raw", "gzip", "buffer" };
+    int reps = 5;
+    int warmup = 1;
+    std::string csv;
+    std::string json;
+    std::string tmpdir = std::filesystem::temp_directory_path().string();
+    bool counters = false;
+};
+
+static void usage(const char* prog) {
+    std::cerr << "Usage: " << prog << " (--file PATH | --generate OBJECT/FORMAT/FIELD[:NLINES]) [OPTIONS]\n"
+        << "  --threads LIST        comma-separated number of threads (default: 1,2,4,... up to the number of cores)\n"
+        << "  --buffers LIST        comma-separated buffer sizes (default: 16K to 16M in powers of 4)\n"
+        << "  --backends LIST       comma-separated subset of raw,gzip,buffer (default: all)\n"
+        << "  --reps N              number of timed repetitions (default: 5)\n"
+        << "  --warmup N            number of untimed repetitions (default: 1)\n"
+        << "  --csv PATH            write the results to a CSV file\n"
+        << "  --json PATH           write the results to a JSON file\n"
+        << "  --tmpdir PATH         directory for temporary copies of the input (default: system temporary directory)\n"
+        << "  --counters            collect hardware performance counters for each phase of the scan of the data lines (Linux only)\n";
+}
+
+static std::vector<std::string> split(const std::string& x) {
+    std::vector<std::string> output;
+    std::stringstream stream(x);
+    std::string current;
+    while (std::getline(stream, current, ',')) {
+        if (!current.empty()) {
+            output.push_back(current);
+        }
+    }
+    return output;
+}
+
+static std::size_t parse_size(std::string x) {
+    std::size_t multiplier = 1;
+    if (!x.empty()) {
+        const char last = x.back();
+        if (last == 'K' || last == 'k') {
+            multiplier = 1024;
+        } else if (last == 'M' || last == 'm') {
+            multiplier = 1024 * 1024;
+        }
+        if (multiplier > 1) {
+            x.pop_back();
+        }
+    }
+    return std::stoull(x) * multiplier;
+}
+
+static Options parse_arguments(int argc, char* argv[]) {
+    Options opt;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) {
+                throw std::runtime_error("missing value for '" + arg + "'");
+            }
+            return argv[++i];
+        };
+
+        if (arg == "--file") {
+            opt.file = next();
+        } else if (arg == "--generate") {
+            opt.generate = next();
+        } else if (arg == "--threads") {
+            opt.threads.clear();
+            for (const auto& x : split(next())) {
+                opt.threads.push_back(std::stoi(x));
+            }
+        } else if (arg == "--buffers") {
+            opt.buffers.clear();
+            for (const auto& x : split(next())) {
+                opt.buffers.push_back(parse_size(x));
+            }
+        } else if (arg == "--backends") {
+            opt.backends = split(next());
+        } else if (arg == "--reps") {
+            opt.reps = std::stoi(next());
+        } else if (arg == "--warmup") {
+            opt.warmup = std::stoi(next());
+        } else if (arg == "--csv") {
+            opt.csv = next();
+        } else if (arg == "--json") {
+            opt.json = next();
+        } else if (arg == "--tmpdir") {
+            opt.tmpdir = next();
+        } else if (arg == "--counters") {
+            opt.counters = true;
+        } else {
+            throw std::runtime_error("unknown argument '" + arg + "'");
+        }
+    }
+
+    if (opt.file.empty() == opt.generate.empty()) {
+        throw std::runtime_error("exactly one of '--file' or '--generate' should be specified");
+    }
+    for (const auto& b : opt.backends) {
+        if (b != "raw" && b != "gzip" && b != "buffer") {
+            throw std::runtime_error("unknown backend '" + b + "'");
+        }
+    }
+    if (opt.reps < 1) {
+        throw std::runtime_error("'--reps' should be positive");
+    }
+
+    if (opt.threads.empty()) {
+        const int ncores = std::max(1u, std::thread::hardware_concurrency());
+        for (int t = 1; t < ncores; t *= 2) {
+            opt.threads.push_back(t);
+        }
+        opt.threads.push_back(ncores);
+    }
+    return opt;
+}
+
+/************************
+ *** Preparing inputs ***
+ ************************/
+
+static GenerateOptions parse_generate_spec(const std::string& spec) {
+    GenerateOptions gen;
+    std::string body = spec;
+    auto colon = body.find(':');
+    if (colon != std::string::npos) {
+        gen.nlines = std::stoull(body.substr(colon + 1));
+        body = body.substr(0, colon);
+    }
+
+    std::vector<std::string> parts;
+    std::stringstream stream(body);
+    std::string current;
+    while (std::getline(stream, current, '/')) {
+        parts.push_back(current);
+    }
+    if (parts.size() != 3) {
+        throw std::runtime_error("generator specification should be 'OBJECT/FORMAT/FIELD[:NLINES]'");
+    }
+
+    if (parts[0] == "matrix") {
+        gen.object = eminem::Object::MATRIX;
+    } else if (parts[0] == "vector") {
+        gen.object = eminem::Object::VECTOR;
+    } else {
+        throw std::runtime_error("unknown object '" + parts[0] + "'");
+    }
+
+    if (parts[1] == "coordinate") {
+        gen.format = eminem::Format::COORDINATE;
+    } else if (parts[1] == "array") {
+        gen.format = eminem::Format::ARRAY;
+    } else {
+        throw std::runtime_error("unknown format '" + parts[1] + "'");
+    }
+
+    const std::vector<eminem::Field> fields { eminem::Field::INTEGER, eminem::Field::REAL, eminem::Field::DOUBLE, eminem::Field::COMPLEX, eminem::Field::PATTERN };
+    auto fIt = std::find_if(fields.begin(), fields.end(), [&](eminem::Field f) -> bool { return parts[2] == field_name(f); });
+    if (fIt == fields.end()) {
+        throw std::runtime_error("unknown field '" + parts[2] + "'");
+    }
+    gen.field = *fIt;
+
+    // For arrays, the number of lines is the number of elements.
+    if (gen.format == eminem::Format::ARRAY) {
+        if (gen.object == eminem::Object::VECTOR) {
+            gen.nrows = gen.nlines;
+        } else {
+            gen.ncols = std::max(1ull, gen.nlines / gen.nrows);
+        }
+    }
+    return gen;
+}
+
+static std::string read_contents(const std::string& path) {
+    std::string contents;
+    gzFile handle = gzopen(path.c_str(), "rb"); // transparently reads uncompressed files as well.
+    if (handle == NULL) {
+        throw std::runtime_error("failed to open '" + path + "'");
+    }
+    std::vector<char> buffer(1 << 20);
+    while (1) {
+        const int got = gzread(handle, buffer.data(), buffer.size());
+        if (got < 0) {
+            gzclose(handle);
+            throw std::runtime_error("failed to read '" + path + "'");
+        }
+        if (got == 0) {
+            break;
+        }
+        contents.append(buffer.data(), got);
+    }
+    gzclose(handle);
+    return contents;
+}
+
+static bool is_gzip_file(const std::string& path) {
+    std::ifstream handle(path, std::ios::binary);
+    unsigned char header[2] = { 0, 0 };
+    handle.read(reinterpret_cast<char*>(header), 2);
+    return header[0] == 0x1f && header[1] == 0x8b;
+}
+
+static void write_plain(const std::string& path, const std::string& contents) {
+    std::ofstream handle(path, std::ios::binary);
+    handle.write(contents.data(), contents.size());
+    if (!handle) {
+        throw std::runtime_error("failed to write '" + path + "'");
+    }
+}
+
+static void write_gzip(const std::string& path, const std::string& contents) {
+    gzFile handle = gzopen(path.c_str(), "wb6");
+    if (handle == NULL || gzwrite(handle, contents.data(), contents.size()) != static_cast<int>(contents.size())) {
+        throw std::runtime_error("failed to write '" + path + "'");
+    }
+    gzclose(handle);
+}
+
+// Each backend reads the same contents, so temporary copies are created for any representation that the input doesn't already have.
+struct Inputs {
+    std::string contents;
+    std::string plain_path;
+    std::string gzip_path;
+    std::vector<std::string> temporaries;
+
+    ~Inputs() {
+        for (const auto& tmp : temporaries) {
+            std::remove(tmp.c_str());
+        }
+    }
+};
+
+static void prepare_inputs(const Options& opt, Inputs& inputs) {
+    const auto needs = [&](const char* backend) -> bool {
+        return std::find(opt.backends.begin(), opt.backends.end(), backend) != opt.backends.end();
+    };
+    const std::string prefix = (std::filesystem::path(opt.tmpdir) / ("eminem_sweep_" + std::to_string(std::chrono::steady_clock::now().time_since_epoch().count()))).string();
+
+    if (!opt.file.empty()) {
+        inputs.contents = read_contents(opt.file);
+        if (is_gzip_file(opt.file)) {
+            inputs.gzip_path = opt.file;
+        } else {
+            inputs.plain_path = opt.file;
+        }
+    } else {
+        inputs.contents = generate(parse_generate_spec(opt.generate));
+    }
+
+    if (needs("raw") && inputs.plain_path.empty()) {
+        inputs.plain_path = prefix + ".mtx";
+        inputs.temporaries.push_back(inputs.plain_path);
+        write_plain(inputs.plain_path, inputs.contents);
+    }
+    if (needs("gzip") && inputs.gzip_path.empty()) {
+        inputs.gzip_path = prefix + ".mtx.gz";
+        inputs.temporaries.push_back(inputs.gzip_path);
+        write_gzip(inputs.gzip_path, inputs.contents);
+    }
+}
+
+/****************
+ *** Scanning ***
+ ****************/
+
+// Phases for which the hardware counters are reported, each of which is summed across all threads.
+// In serial scans, parsing is interleaved with the calls to the store function, so 'parse' also includes the work that is done by 'merge' in parallel scans.
+// 'total' covers the entire scan of the data lines, excluding the preamble.
+enum ReportedPhase { EXTRACT, COUNT_NEWLINES, PARSE, MERGE, TOTAL, NUM_REPORTED_PHASES };
+
+static const char* phase_name(int p) {
+    static const char* names[] = { "extract", "count_newlines", "parse", "merge", "total" };
+    return names[p];
+}
+
+typedef std::array<HardwareCounters::Counts, NUM_REPORTED_PHASES> PhaseCounts;
+
+static HardwareCounters::Counts subtract(const HardwareCounters::Counts& x, const HardwareCounters::Counts& y) {
+    HardwareCounters::Counts output;
+    for (int e = 0; e < HardwareCounters::NUM_EVENTS; ++e) {
+        output.values[e] = x.values[e] - y.values[e];
+        output.available[e] = x.available[e] && y.available[e];
+    }
+    return output;
+}
+
+// Adds the counts from the phases of the most recent scan to 'output'.
+static void add_phases(const PhaseCounterStats& stats, bool serial, PhaseCounts& output) {
+    const auto& scan = stats.get(eminem::ParserPhase::SCAN);
+    const auto& extract = stats.get(eminem::ParserPhase::EXTRACT);
+    const auto& parse = stats.get(eminem::ParserPhase::PARSE);
+    output[EXTRACT].add(extract);
+    output[COUNT_NEWLINES].add(stats.get(eminem::ParserPhase::COUNT_NEWLINES));
+    output[MERGE].add(stats.get(eminem::ParserPhase::MERGE));
+
+    // The scan phase only covers the calling thread, so the workers' parsing is added to get the total.
+    // In serial scans, there are no workers and everything other than the extraction is considered to be parsing.
+    if (serial) {
+        output[PARSE].add(subtract(scan, extract));
+    } else {
+        output[PARSE].add(parse);
+    }
+    output[TOTAL].add(scan);
+    output[TOTAL].add(parse);
+}
+
+// Returns the number of entries, with all values accumulated into 'checksum' to avoid optimizing away the scan.
+// If the parser uses PhaseCounterStats, the hardware counters for each phase of the scan are added to 'counts'.
+template<class Stats_, class Parser_>
+unsigned long long scan_all(Parser_& parser, double& checksum, bool serial, PhaseCounts& counts) {
+    parser.scan_preamble();
+    const auto field = parser.get_banner().field;
+    unsigned long long count = 0;
+
+    if (field == eminem::Field::INTEGER) {
+        parser.scan_integer([&](unsigned long long, unsigned long long, int v) -> void { checksum += v; ++count; });
+    } else if (field == eminem::Field::REAL || field == eminem::Field::DOUBLE) {
+        parser.scan_real([&](unsigned long long, unsigned long long, double v) -> void { checksum += v; ++count; });
+    } else if (field == eminem::Field::COMPLEX) {
+        parser.scan_complex([&](unsigned long long, unsigned long long, std::complex<double> v) -> void { checksum += v.real(); ++count; });
+    } else {
+        parser.scan_pattern([&](unsigned long long r, unsigned long long, bool) -> void { checksum += r; ++count; });
+    }
+
+    if constexpr(std::is_same<Stats_, PhaseCounterStats>::value) {
+        add_phases(parser.get_stats(), serial, counts);
+    } else {
+        (void)serial;
+        (void)counts;
+    }
+    return count;
+}
+
+// Same as the eminem::parse_*() functions, but with a configurable statistics policy.
+template<class Stats_>
+static unsigned long long run_once(const Inputs& inputs, const std::string& backend, const eminem::ParserOptions& popt, double& checksum, PhaseCounts& counts) {
+    const bool serial = popt.num_threads == 1;
+    if (backend == "raw") {
+        auto reader = std::make_unique<byteme::RawFileReader>(inputs.plain_path.c_str(), byteme::RawFileReaderOptions());
+        eminem::Parser<decltype(reader), unsigned long long, Stats_> parser(std::move(reader), popt);
+        return scan_all<Stats_>(parser, checksum, serial, counts);
+    } else if (backend == "gzip") {
+        auto reader = std::make_unique<byteme::GzipFileReader>(inputs.gzip_path.c_str(), byteme::GzipFileReaderOptions());
+        eminem::Parser<decltype(reader), unsigned long long, Stats_> parser(std::move(reader), popt);
+        return scan_all<Stats_>(parser, checksum, serial, counts);
+    } else {
+        auto reader = std::make_unique<byteme::RawBufferReader>(reinterpret_cast<const unsigned char*>(inputs.contents.data()), inputs.contents.size());
+        eminem::Parser<decltype(reader), unsigned long long, Stats_> parser(std::move(reader), popt);
+        return scan_all<Stats_>(parser, checksum, serial, counts);
+    }
+}
+
+struct Result {
+    std::string backend;
+    int threads;
+    std::size_t buffer_size;
+    unsigned long long entries;
+    double median;
+    double min;
+    double max;
+    PhaseCounts counts; // summed across all timed repetitions.
+};
+
+// Derived metrics from the hardware counters for a single phase, each of which is NaN if the relevant counters are not available.
+// All metrics are normalized by the size of the entire input and the total number of entries, so the per-byte or per-entry values of the phases add up to that of the total.
+struct CounterMetrics {
+    static constexpr int size = 9;
+
+    static const char* name(int i) {
+        static const char* names[] = {
+            "cycles_per_byte", "cycles_per_entry", "ipc",
+            "branch_miss_rate", "branch_misses_per_entry",
+            "l1d_misses_per_byte", "l1d_misses_per_entry",
+            "llc_misses_per_byte", "llc_misses_per_entry"
+        };
+        return names[i];
+    }
+
+    std::array<double, size> values;
+
+    CounterMetrics(const Result& res, int phase, int reps, std::size_t nbytes) {
+        const auto& counts = res.counts[phase];
+        auto get = [&](int e) -> double {
+            return (counts.available[e] ? counts.values[e] / reps : std::numeric_limits<double>::quiet_NaN());
+        };
+        const double bytes = nbytes, entries = res.entries;
+        values = {
+            get(HardwareCounters::CYCLES) / bytes,
+            get(HardwareCounters::CYCLES) / entries,
+            get(HardwareCounters::INSTRUCTIONS) / get(HardwareCounters::CYCLES),
+            get(HardwareCounters::BRANCH_MISSES) / get(HardwareCounters::BRANCHES),
+            get(HardwareCounters::BRANCH_MISSES) / entries,
+            get(HardwareCounters::L1D_MISSES) / bytes,
+            get(HardwareCounters::L1D_MISSES) / entries,
+            get(HardwareCounters::LLC_MISSES) / bytes,
+            get(HardwareCounters::LLC_MISSES) / entries
+        };
+    }
+};
+
+static double median(std::vector<double> times) {
+    std::sort(times.begin(), times.end());
+    const auto n = times.size();
+    return (n % 2 ? times[n / 2] : (times[n / 2 - 1] + times[n / 2]) / 2);
+}
+
+/**************
+ *** Output ***
+ **************/
+
+static void write_csv(const std::string& path, const std::vector<Result>& results, std::size_t nbytes, const Options& opt) {
+    std::ofstream handle(path);
+    handle << "backend,threads,buffer_size,bytes,entries,median_seconds,min_seconds,max_seconds,mb_per_second,entries_per_second";
+    if (opt.counters) {
+        for (int p = 0; p < NUM_REPORTED_PHASES; ++p) {
+            for (int i = 0; i < CounterMetrics::size; ++i) {
+                handle << "," << phase_name(p) << "_" << CounterMetrics::name(i);
+            }
+        }
+    }
+    handle << "\n";
+
+    for (const auto& res : results) {
+        handle << res.backend << "," << res.threads << "," << res.buffer_size << "," << nbytes << "," << res.entries << ","
+            << res.median << "," << res.min << "," << res.max << ","
+            << nbytes / res.median / 1e6 << "," << res.entries / res.median;
+        if (opt.counters) {
+            for (int p = 0; p < NUM_REPORTED_PHASES; ++p) {
+                CounterMetrics metrics(res, p, opt.reps, nbytes);
+                for (auto x : metrics.values) {
+                    handle << ",";
+                    if (!std::isnan(x)) {
+                        handle << x;
+                    }
+                }
+            }
+        }
+        handle << "\n";
+    }
+}
+
+static void write_json(const std::string& path, const std::vector<Result>& results, std::size_t nbytes, const Options& opt) {
+    std::ofstream handle(path);
+    handle << "[\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const auto& res = results[i];
+        handle << "  { \"backend\": \"" << res.backend << "\", \"threads\": " << res.threads << ", \"buffer_size\": " << res.buffer_size
+            << ", \"bytes\": " << nbytes << ", \"entries\": " << res.entries
+            << ", \"median_seconds\": " << res.median << ", \"min_seconds\": " << res.min << ", \"max_seconds\": " << res.max
+            << ", \"mb_per_second\": " << nbytes / res.median / 1e6 << ", \"entries_per_second\": " << res.entries / res.median;
+        if (opt.counters) {
+            handle << ", \"counters\": {";
+            for (int p = 0; p < NUM_REPORTED_PHASES; ++p) {
+                CounterMetrics metrics(res, p, opt.reps, nbytes);
+                handle << (p ? ", " : " ") << "\"" << phase_name(p) << "\": {";
+                for (int m = 0; m < CounterMetrics::size; ++m) {
+                    handle << (m ? ", " : " ") << "\"" << CounterMetrics::name(m) << "\": ";
+                    if (std::isnan(metrics.values[m])) {
+                        handle << "null";
+                    } else {
+                        handle << metrics.values[m];
+                    }
+                }
+                handle << " }";
+            }
+            handle << " }";
+        }
+        handle << " }" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    handle << "]\n";
+}
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    try {
+        opt = parse_arguments(argc, argv);
+    } catch (std::exception& e) {
+        std::cerr << e.what() << std::endl;
+        usage(argv[0]);
+        return 1;
+    }
+
+    Inputs inputs;
+    prepare_inputs(opt, inputs);
+    const auto nbytes = inputs.contents.size();
+    std::cout << "input: " << nbytes << " bytes" << std::endl;
+
+    // Each thread opens its own counters in PhaseCounterStats, so we just check whether they can be opened at all.
+    bool counters = false;
+    if (opt.counters) {
+        counters = HardwareCounters().any_available();
+        if (!counters) {
+            std::cerr << "hardware counters are not available, only reporting times" << std::endl;
+        }
+    }
+
+    std::vector<Result> results;
+    double checksum = 0;
+    for (const auto& backend : opt.backends) {
+        for (auto threads : opt.threads) {
+            for (auto bufsize : opt.buffers) {
+                eminem::ParserOptions popt;
+                popt.num_threads = threads;
+                popt.buffer_size = bufsize;
+
+                Result res;
+                res.backend = backend;
+                res.threads = threads;
+                res.buffer_size = bufsize;
+
+                for (int w = 0; w < opt.warmup; ++w) {
+                    PhaseCounts ignored;
+                    res.entries = run_once<eminem::NoStats>(inputs, backend, popt, checksum, ignored);
+                }
+
+                // The times are still reported when counting, though they include the overhead of reading the counters at each phase.
+                std::vector<double> times;
+                for (int r = 0; r < opt.reps; ++r) {
+                    const auto start = std::chrono::steady_clock::now();
+                    if (counters) {
+                        res.entries = run_once<PhaseCounterStats>(inputs, backend, popt, checksum, res.counts);
+                    } else {
+                        res.entries = run_once<eminem::NoStats>(inputs, backend, popt, checksum, res.counts);
+                    }
+                    times.push_back(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+                }
+
+                res.median = median(times);
+                res.min = *std::min_element(times.begin(), times.end());
+                res.max = *std::max_element(times.begin(), times.end());
+                results.push_back(res);
+
+                std::printf("%-6s threads=%-3d buffer=%-9zu median=%.4fs (%.1f MB/s, %.3g entries/s)",
+                    backend.c_str(), threads, bufsize, res.median, nbytes / res.median / 1e6, res.entries / res.median);
+                std::printf("\n");
+                if (counters) {
+                    for (int p = 0; p < NUM_REPORTED_PHASES; ++p) {
+                        CounterMetrics metrics(res, p, opt.reps, nbytes);
+                        std::printf("    %-14s cycles/byte=%.3g ipc=%.3g branch-miss=%.3g%% l1d-miss/byte=%.3g llc-miss/byte=%.3g\n",
+                            phase_name(p), metrics.values[0], metrics.values[2], metrics.values[3] * 100, metrics.values[5], metrics.values[7]);
+                    }
+                }
+                std::fflush(stdout);
+            }
+        }
+    }
+
+    if (!opt.csv.empty()) {
+        write_csv(opt.csv, results, nbytes, opt);
+    }
+    if (!opt.json.empty()) {
+        write_json(opt.json, results, nbytes, opt);
+    }
+
+    std::cout << "checksum: " << checksum << std::endl;
+    return 0;
+}
@@ -0,0 +1,117 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "eminem/choose_options.hpp"
+#include "eminem/from_text.hpp"
+
+#include "temp_file_path.h"
+#include "simulate.h"
+#include "format.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <zlib.h>
+
+TEST(ChooseOptions, Size) {
+    eminem::ChooseOptionsOptions copt;
+    copt.max_threads = 8;
+    copt.min_bytes_per_thread = 1000;
+    copt.min_buffer_size = 10;
+    copt.max_buffer_size = 500;
+    copt.chunks_per_thread = 4;
+
+    // Falls back to serial.
+    auto out = eminem::choose_options(0, false, copt);
+    EXPECT_EQ(out.num_threads, 1);
+    EXPECT_EQ(out.buffer_size, 10);
+    out = eminem::choose_options(1999, false, copt);
+    EXPECT_EQ(out.num_threads, 1);
+
+    // Limited by the number of bytes.
+    out = eminem::choose_options(5500, false, copt);
+    EXPECT_EQ(out.num_threads, 5);
+    EXPECT_EQ(out.buffer_size, 275);
+
+    // Limited by the number of threads.
+    out = eminem::choose_options(16000, false, copt);
+    EXPECT_EQ(out.num_threads, 8);
+    EXPECT_EQ(out.buffer_size, 500);
+
+    // Accounting for compression.
+    out = eminem::choose_options(1000, true, copt);
+    EXPECT_EQ(out.num_threads, 4);
+    EXPECT_EQ(out.buffer_size, 250);
+
+    // Respects the minimum buffer size.
+    copt.min_buffer_size = 400;
+    out = eminem::choose_options(2000, false, copt);
+    EXPECT_EQ(out.num_threads, 2);
+    EXPECT_EQ(out.buffer_size, 400);
+
+    // Only one thread available.
+    copt.max_threads = 1;
+    out = eminem::choose_options(16000, false, copt);
+    EXPECT_EQ(out.num_threads, 1);
+
+    // Using all available threads.
+    copt.max_threads = 0;
+    out = eminem::choose_options(1e12, false, copt);
+    EXPECT_GE(out.num_threads, 1);
+}
+
+TEST(ChooseOptions, File) {
+    std::size_t NR = 192, NC = 132;
+    auto coords = simulate_coordinate(NR, NC, 0.1);
+    auto values = simulate_integer(coords.first.size(), -999, 999);
+    std::stringstream stored;
+    format_coordinate(stored, NR, NC, coords.first, coords.second, values);
+    auto contents = stored.str();
+
+    eminem::ChooseOptionsOptions copt;
+    copt.max_threads = 4;
+    copt.min_bytes_per_thread = 100;
+    copt.min_buffer_size = 10;
+
+    auto path = temp_file_path("choose");
+    {
+        std::ofstream ohandle(path, std::ios::binary);
+        ohandle << contents;
+    }
+
+    auto out = eminem::choose_options(path.c_str(), copt);
+    auto ref = eminem::choose_options(contents.size(), false, copt);
+    EXPECT_EQ(out.num_threads, ref.num_threads);
+    EXPECT_EQ(out.buffer_size, ref.buffer_size);
+
+    // Checking that it can be used for parsing.
+    auto parser = eminem::parse_text_file(path.c_str(), out);
+    parser.scan_preamble();
+    std::vector<int> out_vals;
+    parser.scan_integer([&](eminem::Index, eminem::Index, int v) -> void {
+        out_vals.push_back(v);
+    });
+    EXPECT_EQ(out_vals, values);
+
+    auto gzpath = temp_file_path("choose_gz");
+    {
+        gzFile ohandle = gzopen(gzpath.c_str(), "w");
+        gzwrite(ohandle, contents.data(), contents.size());
+        gzclose(ohandle);
+    }
+
+    std::ifstream gzhandle(gzpath, std::ios::binary | std::ios::ate);
+    auto gzout = eminem::choose_options(gzpath.c_str(), copt);
+    auto gzref = eminem::choose_options(gzhandle.tellg(), true, copt);
+    EXPECT_EQ(gzout.num_threads, gzref.num_threads);
+    EXPECT_EQ(gzout.buffer_size, gzref.buffer_size);
+
+    EXPECT_ANY_THROW({
+        try {
+            eminem::choose_options((path + "_missing").c_str(), copt);
+        } catch (std::exception& e) {
+            EXPECT_THAT(e.what(), ::testing::HasSubstr("failed to open"));
+            throw;
+        }
+    });
+}
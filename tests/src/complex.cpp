@@ -7,6 +7,8 @@
 #include <string>
 #include <memory>
 #include <complex>
+#include <vector>
+#include <cmath>
 
 #include "simulate.h"
 #include "format.h"
@@ -333,6 +335,102 @@ TEST(ParserComplex, QuitEarly) {
     EXPECT_EQ(observed, expected);
 }
 
+TEST(ParserComplex, Split) {
+    std::string input = "%%MatrixMarket matrix coordinate complex general\n10 10 3\n1 2 300 3E3\n4 5 666 -666\n7 8 0 0\n";
+
+    {
+        auto reader = std::make_unique<byteme::RawBufferReader>(reinterpret_cast<const unsigned char*>(input.data()), input.size()); 
+        eminem::Parser parser(std::move(reader), {});
+        parser.scan_preamble();
+
+        std::vector<double> real, imag;
+        EXPECT_TRUE(parser.scan_complex_split([&](eminem::Index, eminem::Index, double re, double im) -> void {
+            real.push_back(re);
+            imag.push_back(im);
+        }));
+        EXPECT_EQ(real, std::vector<double>({ 300, 666, 0 }));
+        EXPECT_EQ(imag, std::vector<double>({ 3000, -666, 0 }));
+    }
+
+    // Quitting early.
+    {
+        auto reader = std::make_unique<byteme::RawBufferReader>(reinterpret_cast<const unsigned char*>(input.data()), input.size()); 
+        eminem::Parser parser(std::move(reader), {});
+        parser.scan_preamble();
+
+        std::vector<float> real, imag;
+        EXPECT_FALSE(parser.template scan_complex_split<float>([&](eminem::Index, eminem::Index, float re, float im) -> bool {
+            real.push_back(re);
+            imag.push_back(im);
+            return re > 0 && im > 0;
+        }));
+        EXPECT_EQ(real, std::vector<float>({ 300, 666 }));
+        EXPECT_EQ(imag, std::vector<float>({ 3000, -666 }));
+    }
+}
+
+TEST(ParserComplex, InPlace) {
+    // Each pair of tokens is converted in place, so we check that the results and errors are the same as std::stod().
+    std::vector<std::string> tokens {
+        "1", "-0", "+5", "123456789012345678", "1.5", "-.25", "+3.", "6.02e23", "1E-5", "-2.5e+10", "0.1", "0.0", "1e308", "2.2250738585072014e-308",
+        "inf", "-Infinity", "nan", "+inf", "0x1p3", "1e-320", "1e400", "+-1", "1.2.3", "1e"
+    };
+
+    auto stod_or_error = [](const std::string& token, double& value) -> bool {
+        if (token.size() >= 2 && token[1] == 'x') {
+            return false;
+        }
+        try {
+            std::size_t n = 0;
+            value = std::stod(token, &n);
+            return n == token.size();
+        } catch (std::exception&) {
+            return false;
+        }
+    };
+
+    for (const auto& first : tokens) {
+        for (const auto& second : tokens) {
+            double expected_real = 0, expected_imag = 0;
+            const bool expect_success = stod_or_error(first, expected_real) && stod_or_error(second, expected_imag);
+
+            for (int buffer_size : { 8, 65536 }) {
+                std::string input = "%%MatrixMarket matrix coordinate complex general\n10 10 2\n1 2 1 2\n3 4 " + first + " " + second + "\n";
+                auto reader = std::make_unique<byteme::RawBufferReader>(reinterpret_cast<const unsigned char*>(input.data()), input.size());
+                eminem::ParserOptions opt;
+                opt.buffer_size = buffer_size;
+                eminem::Parser parser(std::move(reader), opt);
+                parser.scan_preamble();
+
+                std::vector<double> real, imag;
+                bool success = true;
+                try {
+                    parser.scan_complex_split([&](eminem::Index, eminem::Index, double re, double im) -> void {
+                        real.push_back(re);
+                        imag.push_back(im);
+                    });
+                } catch (std::exception&) {
+                    success = false;
+                }
+
+                ASSERT_EQ(success, expect_success) << first << " " << second;
+                if (!success) {
+                    continue;
+                }
+                ASSERT_EQ(real.size(), 2);
+                for (const auto& pair : { std::make_pair(real.back(), expected_real), std::make_pair(imag.back(), expected_imag) }) {
+                    if (std::isnan(pair.second)) {
+                        EXPECT_TRUE(std::isnan(pair.first));
+                    } else {
+                        EXPECT_EQ(pair.first, pair.second);
+                        EXPECT_EQ(std::signbit(pair.first), std::signbit(pair.second));
+                    }
+                }
+            }
+        }
+    }
+}
+
 class ParserComplexSimulatedTest : public ::testing::TestWithParam<std::tuple<int, int> > {
 protected:
     eminem::ParserOptions parse_opt;
@@ -454,6 +552,33 @@ TEST_P(ParserComplexSimulatedTest, ArrayMatrix) {
     test_equal_vectors(out_vals, values);
 }
 
+TEST_P(ParserComplexSimulatedTest, ArrayMatrixSplit) {
+    std::size_t NR = 93, NC = 85;
+    auto values = simulate_complex(NR * NC);
+
+    std::stringstream stored;
+    format_array(stored, NR, NC, values);
+    std::string input = stored.str();
+
+    auto reader = std::make_unique<byteme::RawBufferReader>(reinterpret_cast<const unsigned char*>(input.data()), input.size()); 
+    eminem::Parser parser(std::move(reader), parse_opt);
+    parser.scan_preamble();
+
+    // Filling separate dense arrays for the real and imaginary parts.
+    std::vector<double> real(NR * NC), imag(NR * NC);
+    bool success = parser.scan_complex_split([&](eminem::Index r, eminem::Index c, double re, double im) -> void {
+        real[(c - 1) * NR + (r - 1)] = re;
+        imag[(c - 1) * NR + (r - 1)] = im;
+    });
+    EXPECT_TRUE(success);
+
+    std::vector<std::complex<double> > combined;
+    for (std::size_t i = 0; i < NR * NC; ++i) {
+        combined.emplace_back(real[i], imag[i]);
+    }
+    test_equal_vectors(combined, values);
+}
+
 TEST_P(ParserComplexSimulatedTest, ArrayVector) {
     std::size_t N = 632;
     auto values = simulate_complex(N);
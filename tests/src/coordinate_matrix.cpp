@@ -162,6 +162,36 @@ TEST_P(ParserCoordinateMatrixMiscTest, Errors) {
     test_error("%%MatrixMarket matrix coordinate integer general\n2 2 2\n1 1 1\n", "fewer lines present", parse_opt);
 }
 
+TEST_P(ParserCoordinateMatrixMiscTest, BatchedChecks) {
+    // Using a large buffer so that all lines are processed in the same chunk,
+    // to check that the first error is still reported at its exact location when the indices are checked for the entire chunk.
+    auto opt = parse_opt;
+    opt.buffer_size = 1000;
+    test_error("%%MatrixMarket matrix coordinate integer general\n5 5 4\n1 1 1\n2 2 2\n3 6 3\n4 4 4\n", "column index out of range on line 5", opt);
+    test_error("%%MatrixMarket matrix coordinate integer general\n5 5 4\n1 1 1\n0 2 2\n3 3 3\n4 4 4\n", "row index must be positive on line 4", opt);
+    test_error("%%MatrixMarket matrix coordinate integer general\n5 5 4\n1 1 1\n6 2 2\n3 3 foo\n4 4 4\n", "row index out of range on line 4", opt);
+    test_error("%%MatrixMarket matrix coordinate integer general\n5 5 4\n1 1 1\n2 2 foo\n6 3 3\n4 4 4\n", "expected an integer value on line 4", opt);
+
+    // Lines are still stored up to the expected number of lines when the number of lines is checked for the entire chunk.
+    std::string input = "%%MatrixMarket matrix coordinate integer general\n5 5 2\n1 1 1\n2 2 2\n3 3 3\n";
+    auto reader = std::make_unique<byteme::RawBufferReader>(reinterpret_cast<const unsigned char*>(input.data()), input.size());
+    eminem::Parser parser(std::move(reader), opt);
+    parser.scan_preamble();
+    std::vector<int> observed;
+    EXPECT_ANY_THROW({
+        try {
+            parser.scan_integer([&](eminem::Index, eminem::Index, int val) -> void {
+                observed.push_back(val);
+            });
+        } catch (std::exception& e) {
+            EXPECT_THAT(e.what(), ::testing::HasSubstr("more lines present"));
+            throw;
+        }
+    });
+    std::vector<int> expected { 1, 2 };
+    EXPECT_EQ(observed, expected);
+}
+
 TEST_P(ParserCoordinateMatrixMiscTest, Types) {
     { // Checking it works with real.
         std::string input = "%%MatrixMarket matrix coordinate real general\n10 10 3\n1 5 1.2e-4\n5 1 -12.34\n2 2 inf\n";
@@ -0,0 +1,228 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "byteme/byteme.hpp"
+#include "eminem/Parser.hpp"
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <algorithm>
+
+#include "simulate.h"
+#include "format.h"
+
+class ExecutorTest : public ::testing::Test {
+protected:
+    static std::string simulate_input(int seed) {
+        int NR = 50 + seed, NC = 80;
+        auto coords = simulate_coordinate(NR, NC, 0.1);
+        auto vals = simulate_integer(coords.first.size(), -100, 100);
+        std::stringstream stored;
+        format_coordinate(stored, NR, NC, coords.first, coords.second, vals);
+        return stored.str();
+    }
+
+    static std::vector<int> parse(const std::string& input, const eminem::ParserOptions& opt) {
+        auto reader = std::make_unique<byteme::RawBufferReader>(reinterpret_cast<const unsigned char*>(input.data()), input.size());
+        eminem::Parser parser(std::move(reader), opt);
+        parser.scan_preamble();
+        std::vector<int> output;
+        parser.scan_integer([&](eminem::Index r, eminem::Index c, int val) -> void {
+            output.push_back(r);
+            output.push_back(c);
+            output.push_back(val);
+        });
+        return output;
+    }
+};
+
+TEST_F(ExecutorTest, Shared) {
+    eminem::ParserOptions opt;
+    opt.num_threads = 3;
+    opt.buffer_size = 20;
+    auto pool = std::make_shared<eminem::PersistentThreadPool>(2);
+    EXPECT_EQ(pool->num_threads(), 2);
+    opt.executor = pool;
+
+    eminem::ParserOptions ref_opt;
+    for (int i = 0; i < 5; ++i) {
+        auto input = simulate_input(i);
+        EXPECT_EQ(parse(input, ref_opt), parse(input, opt));
+    }
+}
+
+TEST_F(ExecutorTest, Concurrent) {
+    eminem::ParserOptions opt;
+    opt.num_threads = 2;
+    opt.buffer_size = 20;
+    opt.executor = std::make_shared<eminem::PersistentThreadPool>(3);
+
+    constexpr int num_parses = 4;
+    std::vector<std::string> inputs;
+    std::vector<std::vector<int> > expected;
+    eminem::ParserOptions ref_opt;
+    for (int i = 0; i < num_parses; ++i) {
+        inputs.push_back(simulate_input(i));
+        expected.push_back(parse(inputs.back(), ref_opt));
+    }
+
+    std::vector<std::vector<int> > observed(num_parses);
+    std::vector<std::thread> workers;
+    for (int i = 0; i < num_parses; ++i) {
+        workers.emplace_back([&](int j) -> void {
+            observed[j] = parse(inputs[j], opt);
+        }, i);
+    }
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    EXPECT_EQ(observed, expected);
+}
+
+class InlineExecutor final : public eminem::Executor {
+public:
+    void submit(std::function<void()> job) {
+        ++count;
+        job();
+    }
+    int count = 0;
+};
+
+TEST_F(ExecutorTest, Custom) {
+    eminem::ParserOptions opt;
+    opt.num_threads = 2;
+    opt.buffer_size = 20;
+    auto exec = std::make_shared<InlineExecutor>();
+    opt.executor = exec;
+
+    auto input = simulate_input(0);
+    EXPECT_EQ(parse(input, {}), parse(input, opt));
+    EXPECT_GT(exec->count, 1);
+}
+
+TEST_F(ExecutorTest, Errors) {
+    eminem::ParserOptions opt;
+    opt.num_threads = 2;
+    opt.buffer_size = 1;
+    opt.executor = std::make_shared<eminem::PersistentThreadPool>(2);
+
+    std::string input = "%%MatrixMarket matrix coordinate integer general\n5 5 3\n1 1 1\n2 2 2\n6 1 1\n";
+    EXPECT_ANY_THROW({
+        try {
+            parse(input, opt);
+        } catch (std::exception& e) {
+            EXPECT_THAT(e.what(), ::testing::HasSubstr("row index out of range"));
+            throw;
+        }
+    });
+
+    // Pool is still usable after an error.
+    std::string valid = "%%MatrixMarket matrix coordinate integer general\n5 5 3\n1 1 1\n2 2 2\n5 1 1\n";
+    std::vector<int> expected { 1, 1, 1, 2, 2, 2, 5, 1, 1 };
+    EXPECT_EQ(parse(valid, opt), expected);
+
+    EXPECT_ANY_THROW({
+        try {
+            eminem::PersistentThreadPool pool(0);
+        } catch (std::exception& e) {
+            EXPECT_THAT(e.what(), ::testing::HasSubstr("should be positive"));
+            throw;
+        }
+    });
+}
+
+TEST_F(ExecutorTest, QuitEarly) {
+    eminem::ParserOptions opt;
+    opt.num_threads = 3;
+    opt.buffer_size = 1;
+    opt.executor = std::make_shared<eminem::PersistentThreadPool>(2);
+
+    auto input = simulate_input(1);
+    for (int i = 0; i < 3; ++i) {
+        auto reader = std::make_unique<byteme::RawBufferReader>(reinterpret_cast<const unsigned char*>(input.data()), input.size());
+        eminem::Parser parser(std::move(reader), opt);
+        parser.scan_preamble();
+        int count = 0;
+        EXPECT_FALSE(parser.scan_integer([&](eminem::Index, eminem::Index, int) -> bool {
+            ++count;
+            return count < 5;
+        }));
+        EXPECT_EQ(count, 5);
+    }
+}
+
+class CountingExecutor final : public eminem::Executor {
+public:
+    CountingExecutor(int num_threads) : my_pool(num_threads) {}
+
+    // We count the number of jobs that were submitted but not yet started at each submission.
+    // If only one chunk is in flight at any given time, this should always be zero.
+    void submit(std::function<void()> job) {
+        {
+            std::lock_guard lck(my_mut);
+            my_max = std::max(my_max, my_unstarted);
+            ++my_unstarted;
+        }
+        my_pool.submit([this,job]() -> void {
+            {
+                std::lock_guard lck(my_mut);
+                --my_unstarted;
+            }
+            job();
+        });
+    }
+
+    int max_unstarted() {
+        std::lock_guard lck(my_mut);
+        return my_max;
+    }
+
+private:
+    eminem::PersistentThreadPool my_pool;
+    std::mutex my_mut;
+    int my_unstarted = 0, my_max = 0;
+};
+
+TEST_F(ExecutorTest, MaxInflight) {
+    auto input = simulate_input(2);
+    auto ref = parse(input, {});
+
+    eminem::ParserOptions opt;
+    opt.num_threads = 4;
+    opt.buffer_size = 50;
+
+    // Only one chunk can be processed at a time.
+    {
+        auto exec = std::make_shared<CountingExecutor>(4);
+        opt.executor = exec;
+        opt.max_inflight_bytes = 1;
+        EXPECT_EQ(parse(input, opt), ref);
+        EXPECT_EQ(exec->max_unstarted(), 0);
+    }
+
+    // Some chunks can be processed concurrently.
+    {
+        auto exec = std::make_shared<CountingExecutor>(4);
+        opt.executor = exec;
+        opt.max_inflight_bytes = 1000;
+        EXPECT_EQ(parse(input, opt), ref);
+    }
+
+    // Early quits still work.
+    {
+        auto reader = std::make_unique<byteme::RawBufferReader>(reinterpret_cast<const unsigned char*>(input.data()), input.size());
+        opt.max_inflight_bytes = 1;
+        eminem::Parser parser(std::move(reader), opt);
+        parser.scan_preamble();
+        int count = 0;
+        EXPECT_FALSE(parser.scan_integer([&](eminem::Index, eminem::Index, int) -> bool {
+            ++count;
+            return count < 5;
+        }));
+        EXPECT_EQ(count, 5);
+    }
+}
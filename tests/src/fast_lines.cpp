@@ -0,0 +1,369 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "byteme/byteme.hpp"
+#include "eminem/Parser.hpp"
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <functional>
+
+TEST(FastLines, Field) {
+    std::mt19937_64 rng(42);
+    std::uint64_t upper = 1;
+    for (int ndigits = 1; ndigits <= 15; ++ndigits) {
+        const auto lower = upper / 10 * (ndigits > 1);
+        upper *= 10;
+        for (int i = 0; i < 100; ++i) {
+            const std::uint64_t expected = lower + rng() % (upper - lower);
+            std::string line = std::to_string(expected) + " " + std::string(16, 'x');
+
+            std::size_t position = 0;
+            std::uint64_t output = 0;
+            EXPECT_TRUE(eminem::parse_fast_field(line.data(), line.size(), position, ' ', output));
+            EXPECT_EQ(output, expected);
+            EXPECT_EQ(position, std::to_string(expected).size() + 1);
+        }
+    }
+
+    // Leading zeros are fine.
+    {
+        std::string line = "000123\n" + std::string(16, 'x');
+        std::size_t position = 0;
+        int output = 0;
+        EXPECT_TRUE(eminem::parse_fast_field(line.data(), line.size(), position, '\n', output));
+        EXPECT_EQ(output, 123);
+        EXPECT_EQ(position, 7);
+    }
+
+    // Too many digits, or too large for the type.
+    {
+        std::string line = "1234567890123456 " + std::string(16, 'x');
+        std::size_t position = 0;
+        std::uint64_t output = 0;
+        EXPECT_FALSE(eminem::parse_fast_field(line.data(), line.size(), position, ' ', output));
+
+        line = "256 " + std::string(16, 'x');
+        unsigned char small = 0;
+        EXPECT_FALSE(eminem::parse_fast_field(line.data(), line.size(), position, ' ', small));
+        line = "255 " + std::string(16, 'x');
+        EXPECT_TRUE(eminem::parse_fast_field(line.data(), line.size(), position, ' ', small));
+        EXPECT_EQ(small, 255);
+    }
+}
+
+TEST(FastLines, Line) {
+    auto parse = [](std::string line, bool pattern) -> std::size_t {
+        line += std::string(48, 'x');
+        int row, col, value;
+        if (pattern) {
+            return eminem::parse_fast_coordinate_line(line.data(), line.size(), row, col);
+        } else {
+            return eminem::parse_fast_coordinate_line(line.data(), line.size(), row, col, value);
+        }
+    };
+
+    EXPECT_EQ(parse("12345 678 3\n", false), 12);
+    EXPECT_EQ(parse("12345 678\n", true), 10);
+
+    // Anything unusual is left to the general parser.
+    EXPECT_EQ(parse("12345 678 3\r\n", false), 0);
+    EXPECT_EQ(parse("12345  678 3\n", false), 0);
+    EXPECT_EQ(parse(" 12345 678 3\n", false), 0);
+    EXPECT_EQ(parse("12345\t678 3\n", false), 0);
+    EXPECT_EQ(parse("12345 678 3 \n", false), 0);
+    EXPECT_EQ(parse("12345 678 -3\n", false), 0);
+    EXPECT_EQ(parse("12345 678 +3\n", false), 0);
+    EXPECT_EQ(parse("12345 678 3.5\n", false), 0);
+    EXPECT_EQ(parse("12345 678\n", false), 0);
+    EXPECT_EQ(parse("12345 678 3\n", true), 0);
+    EXPECT_EQ(parse("%12345 678 3\n", false), 0);
+    EXPECT_EQ(parse("\n", true), 0);
+
+    // Lines that are not entirely contained in the buffer.
+    std::string line = "1 2\n";
+    int row, col;
+    EXPECT_EQ(eminem::parse_fast_coordinate_line(line.data(), line.size(), row, col), 0);
+}
+
+TEST(FastLines, WellFormedChunk) {
+    auto check = [](const std::string& chunk) -> bool {
+        return eminem::is_well_formed_chunk(chunk);
+    };
+
+    EXPECT_TRUE(check(""));
+    EXPECT_TRUE(check("1 2 3.5\n4 5 6e8\n"));
+    EXPECT_TRUE(check("1 2 3.5\n4 5 6e8")); // no trailing newline at the end of the file.
+
+    EXPECT_FALSE(check("%foo\n1 2 3.5\n"));
+    EXPECT_FALSE(check("1 2 3.5\n%foo\n"));
+    EXPECT_FALSE(check("\n1 2 3.5\n"));
+    EXPECT_FALSE(check("1 2 3.5\n\n4 5 6\n"));
+    EXPECT_FALSE(check(" 1 2 3.5\n"));
+    EXPECT_FALSE(check("1 2 3.5\n 4 5 6\n"));
+    EXPECT_FALSE(check("1  2 3.5\n"));
+    EXPECT_FALSE(check("1 2 3.5 \n"));
+    EXPECT_FALSE(check("1 2 3.5 "));
+    EXPECT_FALSE(check("1\t2 3.5\n"));
+    EXPECT_FALSE(check("1 2 3.5\r\n"));
+}
+
+class FastLinesTest : public ::testing::TestWithParam<std::tuple<int, int> > {
+protected:
+    eminem::ParserOptions parse_opt;
+
+    void SetUp() {
+        auto param = GetParam();
+        parse_opt.num_threads = std::get<0>(param);
+        parse_opt.buffer_size = std::get<1>(param);
+    }
+
+    // Mostly well-formed lines with the occasional oddity, to check that we switch between the fast and general parsers correctly.
+    static std::string simulate(bool pattern, std::vector<int>& rows, std::vector<int>& cols, std::vector<int>& vals) {
+        std::mt19937_64 rng(pattern + 100);
+        const int NR = 123456, NC = 789;
+        const int nlines = 2000;
+        std::string output = "%%MatrixMarket matrix coordinate " + std::string(pattern ? "pattern" : "integer") + " general\n";
+        output += std::to_string(NR) + " " + std::to_string(NC) + " " + std::to_string(nlines) + "\n";
+
+        for (int i = 0; i < nlines; ++i) {
+            rows.push_back(rng() % NR + 1);
+            cols.push_back(rng() % NC + 1);
+            std::string sep = " ";
+            std::string end = "\n";
+            switch (rng() % 20) {
+                case 0: output += "%comment\n"; break;
+                case 1: output += "\n"; break;
+                case 2: sep = "  "; break;
+                case 3: sep = "\t"; break;
+                case 4: end = "\r\n"; break;
+                case 5: output += " "; break;
+                case 6: end = " \n"; break;
+            }
+
+            output += std::to_string(rows.back()) + sep + std::to_string(cols.back());
+            if (!pattern) {
+                vals.push_back(rng() % 100 == 0 ? -static_cast<int>(rng() % 100) : static_cast<int>(rng() % 1000));
+                output += sep + std::to_string(vals.back());
+            }
+            output += end;
+        }
+
+        return output;
+    }
+
+    template<class Function_>
+    static void scan(const std::string& input, const eminem::ParserOptions& opt, Function_ fun) {
+        auto reader = std::make_unique<byteme::RawBufferReader>(reinterpret_cast<const unsigned char*>(input.data()), input.size());
+        eminem::Parser parser(std::move(reader), opt);
+        parser.scan_preamble();
+        fun(parser);
+    }
+};
+
+TEST_P(FastLinesTest, Integer) {
+    std::vector<int> rows, cols, vals;
+    auto input = simulate(false, rows, cols, vals);
+
+    std::vector<int> out_rows, out_cols, out_vals;
+    scan(input, parse_opt, [&](auto& parser) -> void {
+        parser.scan_integer([&](eminem::Index r, eminem::Index c, int v) -> void {
+            out_rows.push_back(r);
+            out_cols.push_back(c);
+            out_vals.push_back(v);
+        });
+    });
+
+    EXPECT_EQ(rows, out_rows);
+    EXPECT_EQ(cols, out_cols);
+    EXPECT_EQ(vals, out_vals);
+}
+
+TEST_P(FastLinesTest, Pattern) {
+    std::vector<int> rows, cols, vals;
+    auto input = simulate(true, rows, cols, vals);
+
+    std::vector<int> out_rows, out_cols;
+    scan(input, parse_opt, [&](auto& parser) -> void {
+        parser.scan_pattern([&](eminem::Index r, eminem::Index c, bool) -> void {
+            out_rows.push_back(r);
+            out_cols.push_back(c);
+        });
+    });
+
+    EXPECT_EQ(rows, out_rows);
+    EXPECT_EQ(cols, out_cols);
+}
+
+TEST_P(FastLinesTest, Errors) {
+    std::string header = "%%MatrixMarket matrix coordinate integer general\n100 100 5\n";
+    std::string body;
+    for (int i = 1; i <= 3; ++i) {
+        body += std::to_string(i) + " " + std::to_string(i) + " " + std::to_string(i) + "\n";
+    }
+    std::string padding(100, '\n'); // ensuring that the offending line is handled by the fast kernel.
+
+    auto test_error = [&](const std::string& input, eminem::ParseErrorCode code, eminem::LineIndex line) -> void {
+        try {
+            scan(input, parse_opt, [&](auto& parser) -> void {
+                parser.scan_integer([&](eminem::Index, eminem::Index, int){});
+            });
+            ADD_FAILURE() << "expected a ParseError";
+        } catch (eminem::ParseError& e) {
+            EXPECT_EQ(e.code(), code);
+            EXPECT_EQ(e.position(), line);
+        }
+    };
+
+    test_error(header + body + "101 1 1\n5 5 5\n" + padding, eminem::ParseErrorCode::INDEX_OUT_OF_RANGE, 6);
+    test_error(header + body + "1 0 1\n5 5 5\n" + padding, eminem::ParseErrorCode::INDEX_NOT_POSITIVE, 6);
+    test_error(header + body + "1 1 9999999999\n5 5 5\n" + padding, eminem::ParseErrorCode::VALUE_OVERFLOW, 6);
+}
+
+TEST_P(FastLinesTest, Real) {
+    // Most chunks are well-formed but a few contain comments or irregular whitespace.
+    std::mt19937_64 rng(69);
+    const int nlines = 2000;
+    std::string input = "%%MatrixMarket matrix coordinate real general\n1000 1000 " + std::to_string(nlines) + "\n";
+    for (int i = 0; i < nlines; ++i) {
+        if (i % 500 == 250) {
+            input += "%comment\n";
+        }
+        std::string sep = (i % 700 == 350 ? "\t" : " ");
+        input += std::to_string(rng() % 1000 + 1) + sep + std::to_string(rng() % 1000 + 1) + sep + std::to_string(static_cast<double>(rng() % 10000) / 8) + "\n";
+    }
+
+    auto collect = [&](const eminem::ParserOptions& opt) -> std::vector<std::tuple<eminem::Index, eminem::Index, double> > {
+        std::vector<std::tuple<eminem::Index, eminem::Index, double> > output;
+        scan(input, opt, [&](auto& parser) -> void {
+            parser.scan_real([&](eminem::Index r, eminem::Index c, double v) -> void {
+                output.emplace_back(r, c, v);
+            });
+        });
+        return output;
+    };
+
+    auto ref = collect(eminem::ParserOptions());
+    EXPECT_EQ(ref.size(), nlines);
+    EXPECT_EQ(collect(parse_opt), ref);
+
+    // Errors in well-formed chunks are reported in the same way.
+    auto get_error = [&](const std::string& contents, const eminem::ParserOptions& opt) -> std::string {
+        try {
+            scan(contents, opt, [&](auto& parser) -> void {
+                parser.scan_real([&](eminem::Index, eminem::Index, double){});
+            });
+        } catch (std::exception& e) {
+            return e.what();
+        }
+        return "";
+    };
+
+    std::string clean = "%%MatrixMarket matrix coordinate real general\n100 100 50\n";
+    for (int i = 1; i <= 20; ++i) {
+        clean += std::to_string(i) + " " + std::to_string(i) + " " + std::to_string(i) + ".5\n";
+    }
+    for (const auto& bad : std::vector<std::string>{ "5 5 foo\n", "5 500 1\n", "5 x 1\n", "5 5\n", "5 5 5 5\n", "99999999999999999999999 5 1\n" }) {
+        auto contents = clean + bad + clean.substr(clean.find("1 1"));
+        auto expected = get_error(contents, eminem::ParserOptions());
+        EXPECT_NE(expected, "");
+        EXPECT_EQ(get_error(contents, parse_opt), expected);
+    }
+}
+
+TEST_P(FastLinesTest, VectorAndArray) {
+    struct Layout {
+        std::string header;
+        std::function<std::string(int)> line;
+        std::vector<std::string> bad;
+    };
+    std::vector<Layout> layouts{
+        { "vector coordinate real", [](int i) -> std::string { return std::to_string(i % 100 + 1) + " " + std::to_string(i) + ".5"; }, { "5 foo\n", "500 1\n", "x 1\n", "5\n" } },
+        { "vector coordinate pattern", [](int i) -> std::string { return std::to_string(i % 100 + 1); }, { "500\n", "x\n", "5 5\n" } },
+        { "matrix array real", [](int i) -> std::string { return std::to_string(i) + "e-2"; }, { "foo\n", "1.5x\n", "-\n" } },
+        { "vector array real", [](int i) -> std::string { return "-" + std::to_string(i); }, { "foo\n", "1.5x\n", "-\n" } }
+    };
+
+    for (const auto& layout : layouts) {
+        // Most chunks are well-formed but a few contain comments or irregular whitespace.
+        const int nlines = 2000;
+        auto size_line = [&](int n) -> std::string {
+            if (layout.header.find("coordinate") != std::string::npos) {
+                return "100 " + std::to_string(n) + "\n";
+            } else if (layout.header.find("matrix") == 0) {
+                return std::to_string(n) + " 1\n";
+            } else {
+                return std::to_string(n) + "\n";
+            }
+        };
+        std::string input = "%%MatrixMarket " + layout.header + " general\n" + size_line(nlines);
+        for (int i = 0; i < nlines; ++i) {
+            if (i % 500 == 250) {
+                input += "%comment\n";
+            }
+            if (i % 700 == 350) {
+                input += " ";
+            }
+            input += layout.line(i) + "\n";
+        }
+
+        auto collect = [&](const eminem::ParserOptions& opt) -> std::vector<std::tuple<eminem::Index, eminem::Index, double> > {
+            std::vector<std::tuple<eminem::Index, eminem::Index, double> > output;
+            scan(input, opt, [&](auto& parser) -> void {
+                if (parser.get_banner().field == eminem::Field::PATTERN) {
+                    parser.scan_pattern([&](eminem::Index r, eminem::Index c, bool) -> void {
+                        output.emplace_back(r, c, 1);
+                    });
+                } else {
+                    parser.scan_real([&](eminem::Index r, eminem::Index c, double v) -> void {
+                        output.emplace_back(r, c, v);
+                    });
+                }
+            });
+            return output;
+        };
+
+        auto ref = collect(eminem::ParserOptions());
+        EXPECT_EQ(ref.size(), nlines);
+        EXPECT_EQ(collect(parse_opt), ref);
+
+        // Errors in well-formed chunks are reported in the same way.
+        auto get_error = [&](const std::string& contents, const eminem::ParserOptions& opt) -> std::string {
+            try {
+                scan(contents, opt, [&](auto& parser) -> void {
+                    if (parser.get_banner().field == eminem::Field::PATTERN) {
+                        parser.scan_pattern([&](eminem::Index, eminem::Index, bool){});
+                    } else {
+                        parser.scan_real([&](eminem::Index, eminem::Index, double){});
+                    }
+                });
+            } catch (std::exception& e) {
+                return e.what();
+            }
+            return "";
+        };
+
+        std::string clean;
+        for (int i = 1; i <= 20; ++i) {
+            clean += layout.line(i) + "\n";
+        }
+        for (const auto& bad : layout.bad) {
+            auto contents = "%%MatrixMarket " + layout.header + " general\n" + size_line(41) + clean + bad + clean;
+            auto expected = get_error(contents, eminem::ParserOptions());
+            EXPECT_NE(expected, "");
+            EXPECT_EQ(get_error(contents, parse_opt), expected);
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    FastLines,
+    FastLinesTest,
+    ::testing::Combine(
+        ::testing::Values(1, 2, 3), // number of threads
+        ::testing::Values(20, 1000, 65536) // buffer size
+    )
+);
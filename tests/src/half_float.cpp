@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+
+#include "byteme/byteme.hpp"
+#include "eminem/Parser.hpp"
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <cmath>
+#include <limits>
+
+TEST(HalfFloat, Float16RoundTrip) {
+    // Every half-precision value should be exactly representable as a float and convert back to the same bits.
+    for (std::uint32_t i = 0; i < 65536; ++i) {
+        eminem::Float16 h;
+        h.bits = static_cast<std::uint16_t>(i);
+        const float f = h.to_float();
+        if (std::isnan(f)) {
+            EXPECT_TRUE((i & 0x7C00) == 0x7C00 && (i & 0x3FF));
+            EXPECT_TRUE(std::isnan(eminem::Float16(f).to_float()));
+        } else {
+            EXPECT_EQ(eminem::Float16(f).bits, i) << i;
+        }
+    }
+}
+
+TEST(HalfFloat, Float16Rounding) {
+    EXPECT_EQ(eminem::Float16(1.0f).bits, 0x3C00);
+    EXPECT_EQ(eminem::Float16(-2.0f).bits, 0xC000);
+    EXPECT_EQ(eminem::Float16(65504.0f).bits, 0x7BFF);
+    EXPECT_EQ(eminem::Float16(0.1f).to_float(), 0.0999755859375f);
+
+    // Ties go to even.
+    EXPECT_EQ(eminem::Float16(1.0f + std::ldexp(1.0f, -11)).bits, 0x3C00);
+    EXPECT_EQ(eminem::Float16(1.0f + 3 * std::ldexp(1.0f, -11)).bits, 0x3C02);
+    EXPECT_EQ(eminem::Float16(std::ldexp(1.0f, -25)).bits, 0x0000); // halfway to the smallest subnormal.
+    EXPECT_EQ(eminem::Float16(3 * std::ldexp(1.0f, -25)).bits, 0x0002);
+
+    // Overflow and specials.
+    EXPECT_EQ(eminem::Float16(65520.0f).bits, 0x7C00);
+    EXPECT_EQ(eminem::Float16(-1e10f).bits, 0xFC00);
+    EXPECT_EQ(eminem::Float16(std::numeric_limits<float>::infinity()).bits, 0x7C00);
+    EXPECT_TRUE(std::isnan(eminem::Float16(std::numeric_limits<float>::quiet_NaN()).to_float()));
+    EXPECT_EQ(eminem::Float16(1e-10f).bits, 0x0000);
+    EXPECT_EQ(eminem::Float16(-1e-10f).bits, 0x8000);
+}
+
+TEST(HalfFloat, BFloat16) {
+    for (std::uint32_t i = 0; i < 65536; ++i) {
+        eminem::BFloat16 b;
+        b.bits = static_cast<std::uint16_t>(i);
+        const float f = static_cast<float>(b);
+        if (std::isnan(f)) {
+            EXPECT_TRUE(std::isnan(eminem::BFloat16(f).to_float()));
+        } else {
+            EXPECT_EQ(eminem::BFloat16(f).bits, i) << i;
+        }
+    }
+
+    EXPECT_EQ(eminem::BFloat16(1.0f).bits, 0x3F80);
+    EXPECT_EQ(eminem::BFloat16(1.0f + std::ldexp(1.0f, -8)).bits, 0x3F80); // tie to even.
+    EXPECT_EQ(eminem::BFloat16(1.0f + 3 * std::ldexp(1.0f, -8)).bits, 0x3F82);
+    EXPECT_EQ(eminem::BFloat16(std::numeric_limits<float>::max()).bits, 0x7F80); // rounds up to infinity.
+
+    // Signalling NaNs with only low mantissa bits set are not truncated to infinity.
+    const float snan = eminem::bits_to_float(0x7F800001u);
+    EXPECT_TRUE(std::isnan(eminem::BFloat16(snan).to_float()));
+}
+
+class HalfFloatScanTest : public ::testing::TestWithParam<int> {};
+
+TEST_P(HalfFloatScanTest, ScanReal) {
+    std::string input = "%%MatrixMarket matrix coordinate real general\n10 10 5\n1 2 0.1\n3 4 -65504\n5 6 1e10\n7 8 nan\n9 10 3.14159\n";
+
+    auto run = [&](auto type) -> auto {
+        typedef decltype(type) Type;
+        eminem::ParserOptions opt;
+        opt.num_threads = GetParam();
+        opt.buffer_size = 20;
+        auto reader = std::make_unique<byteme::RawBufferReader>(reinterpret_cast<const unsigned char*>(input.data()), input.size()); 
+        eminem::Parser parser(std::move(reader), opt);
+        parser.scan_preamble();
+
+        std::vector<Type> observed;
+        EXPECT_TRUE(parser.template scan_real<Type>([&](eminem::Index, eminem::Index, Type val) {
+            observed.push_back(val);
+        }));
+        return observed;
+    };
+
+    std::vector<float> ref { 0.1f, -65504.0f, 1e10f, std::numeric_limits<float>::quiet_NaN(), 3.14159f };
+
+    auto half = run(eminem::Float16());
+    ASSERT_EQ(half.size(), ref.size());
+    for (std::size_t i = 0; i < ref.size(); ++i) {
+        if (std::isnan(ref[i])) {
+            EXPECT_TRUE(std::isnan(half[i].to_float()));
+        } else {
+            EXPECT_EQ(half[i].bits, eminem::Float16(ref[i]).bits);
+        }
+    }
+    EXPECT_EQ(half[2].to_float(), std::numeric_limits<float>::infinity());
+
+    auto brain = run(eminem::BFloat16());
+    ASSERT_EQ(brain.size(), ref.size());
+    for (std::size_t i = 0; i < ref.size(); ++i) {
+        if (std::isnan(ref[i])) {
+            EXPECT_TRUE(std::isnan(brain[i].to_float()));
+        } else {
+            EXPECT_EQ(brain[i].bits, eminem::BFloat16(ref[i]).bits);
+        }
+    }
+}
+
+TEST_P(HalfFloatScanTest, DoubleRounding) {
+    // Values that lie just beside a 16-bit midpoint, where rounding to a float first would land exactly on the midpoint and then round to even.
+    std::string input = "%%MatrixMarket vector array real\n6\n1.00048828125\n1.00048828125000001\n-1.00048828124999999\n1.00390625\n1.00390625000000001\n0.99975585937499999\n";
+
+    auto run = [&](auto type) -> auto {
+        typedef decltype(type) Type;
+        eminem::ParserOptions opt;
+        opt.num_threads = GetParam();
+        opt.buffer_size = 20;
+        auto reader = std::make_unique<byteme::RawBufferReader>(reinterpret_cast<const unsigned char*>(input.data()), input.size()); 
+        eminem::Parser parser(std::move(reader), opt);
+        parser.scan_preamble();
+
+        std::vector<float> observed;
+        EXPECT_TRUE(parser.template scan_real<Type>([&](eminem::Index, eminem::Index, Type val) {
+            observed.push_back(val.to_float());
+        }));
+        return observed;
+    };
+
+    auto half = run(eminem::Float16());
+    std::vector<float> half_ref { 1, 1 + std::ldexp(1.0f, -10), -1, 1.00390625f, 1.00390625f, 0.99951171875f };
+    EXPECT_EQ(half, half_ref);
+
+    auto brain = run(eminem::BFloat16());
+    std::vector<float> brain_ref { 1, 1, -1, 1, 1 + std::ldexp(1.0f, -7), 1 };
+    EXPECT_EQ(brain, brain_ref);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    HalfFloat,
+    HalfFloatScanTest,
+    ::testing::Values(1, 2, 3) // number of threads
+);
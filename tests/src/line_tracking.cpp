@@ -0,0 +1,176 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "byteme/byteme.hpp"
+#include "eminem/Parser.hpp"
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <complex>
+
+#include "simulate.h"
+#include "format.h"
+
+class LineTrackingTest : public ::testing::TestWithParam<std::tuple<int, int> > {
+protected:
+    eminem::ParserOptions parse_opt;
+
+    void SetUp() {
+        auto param = GetParam();
+        parse_opt.num_threads = std::get<0>(param);
+        parse_opt.buffer_size = std::get<1>(param);
+        parse_opt.track_line_numbers = false;
+    }
+
+    template<class Function_>
+    static void scan(const std::string& input, const eminem::ParserOptions& opt, Function_ fun) {
+        auto reader = std::make_unique<byteme::RawBufferReader>(reinterpret_cast<const unsigned char*>(input.data()), input.size());
+        eminem::Parser parser(std::move(reader), opt);
+        parser.scan_preamble();
+        fun(parser);
+    }
+
+    // Checks that the reported byte offset lies within the offending line, which is identified by its unique contents.
+    // Some errors are only detected after the terminating newline is consumed, so the offset may also be one past the end of the line.
+    static void test_error(const std::string& input, const std::string& bad_line, const std::string& msg, const eminem::ParserOptions& opt) {
+        auto start = input.find(bad_line);
+        ASSERT_NE(start, std::string::npos);
+
+        EXPECT_ANY_THROW({
+            try {
+                scan(input, opt, [&](auto& parser) -> void {
+                    parser.scan_real([&](eminem::Index, eminem::Index, double){});
+                });
+            } catch (std::exception& e) {
+                std::string what = e.what();
+                EXPECT_THAT(what, ::testing::HasSubstr(msg));
+                EXPECT_THAT(what, ::testing::Not(::testing::HasSubstr("on line")));
+
+                const std::string marker = "at byte offset ";
+                auto found = what.find(marker);
+                EXPECT_NE(found, std::string::npos);
+                auto offset = std::stoull(what.substr(found + marker.size()));
+                EXPECT_GE(offset, start);
+                EXPECT_LE(offset, start + bad_line.size() + 1);
+                throw;
+            }
+        });
+    }
+};
+
+TEST_P(LineTrackingTest, Coordinate) {
+    int NR = 91, NC = 37;
+    auto coords = simulate_coordinate(NR, NC, 0.1);
+    auto vals = simulate_real(coords.first.size());
+    std::stringstream stored;
+    format_coordinate(stored, NR, NC, coords.first, coords.second, vals);
+    auto input = stored.str();
+
+    std::vector<eminem::Index> ref_rows, ref_cols;
+    std::vector<double> ref_vals;
+    scan(input, eminem::ParserOptions(), [&](auto& parser) -> void {
+        parser.scan_real([&](eminem::Index r, eminem::Index c, double v) -> void {
+            ref_rows.push_back(r);
+            ref_cols.push_back(c);
+            ref_vals.push_back(v);
+        });
+    });
+
+    std::vector<eminem::Index> rows, cols;
+    std::vector<double> out_vals;
+    scan(input, parse_opt, [&](auto& parser) -> void {
+        parser.scan_real([&](eminem::Index r, eminem::Index c, double v) -> void {
+            rows.push_back(r);
+            cols.push_back(c);
+            out_vals.push_back(v);
+        });
+    });
+
+    EXPECT_EQ(rows, ref_rows);
+    EXPECT_EQ(cols, ref_cols);
+    EXPECT_EQ(out_vals, ref_vals);
+}
+
+TEST_P(LineTrackingTest, Other) {
+    // Array.
+    {
+        std::string input = "%%MatrixMarket matrix array integer general\n2 3\n%foo\n1\n2\n\n3\n4\n5\n6\n";
+        std::vector<int> out_vals;
+        scan(input, parse_opt, [&](auto& parser) -> void {
+            parser.scan_integer([&](eminem::Index, eminem::Index, int v) -> void {
+                out_vals.push_back(v);
+            });
+        });
+        std::vector<int> expected { 1, 2, 3, 4, 5, 6 };
+        EXPECT_EQ(out_vals, expected);
+    }
+
+    // Pattern vector.
+    {
+        std::string input = "%%MatrixMarket vector coordinate pattern general\n10 3\n2\n%foo\n5\n7\n";
+        std::vector<eminem::Index> rows;
+        scan(input, parse_opt, [&](auto& parser) -> void {
+            parser.scan_pattern([&](eminem::Index r, eminem::Index, bool) -> void {
+                rows.push_back(r);
+            });
+        });
+        std::vector<eminem::Index> expected { 2, 5, 7 };
+        EXPECT_EQ(rows, expected);
+    }
+
+    // Complex vector.
+    {
+        std::string input = "%%MatrixMarket vector coordinate complex general\n10 2\n2 1 2\n\n5 3 4\n";
+        std::vector<std::complex<double> > out_vals;
+        scan(input, parse_opt, [&](auto& parser) -> void {
+            parser.scan_complex([&](eminem::Index, eminem::Index, std::complex<double> v) -> void {
+                out_vals.push_back(v);
+            });
+        });
+        std::vector<std::complex<double> > expected { { 1, 2 }, { 3, 4 } };
+        EXPECT_EQ(out_vals, expected);
+    }
+}
+
+TEST_P(LineTrackingTest, Errors) {
+    std::string header = "%%MatrixMarket matrix coordinate real general\n% some comment\n10 10 6\n";
+    std::string body = "1 1 1.5\n2 2 2.5\n%stuff\n\n3 3 3.5\n4 4 4.5\n";
+    test_error(header + body + "11 5 5.5\n6 6 6.5\n", "11 5 5.5", "row index out of range", parse_opt);
+    test_error(header + body + "5 0 5.5\n6 6 6.5\n", "5 0 5.5", "column index must be positive", parse_opt);
+    test_error(header + body + "5 5 foo\n6 6 6.5\n", "5 5 foo", "failed to convert", parse_opt);
+    test_error(header + body + "5 5 5.5 1\n6 6 6.5\n", "5 5 5.5 1", "more fields than expected", parse_opt);
+    test_error(header + body + "5 5\n6 6 6.5\n", "5 5\n", "unexpected newline", parse_opt);
+    test_error(header + body + "5 5 5.5\n6 6 6.5\n7", "7", "unexpected end of file", parse_opt);
+
+    // Line counts are still checked.
+    EXPECT_ANY_THROW({
+        try {
+            scan(header + body, parse_opt, [&](auto& parser) -> void {
+                parser.scan_real([&](eminem::Index, eminem::Index, double){});
+            });
+        } catch (std::exception& e) {
+            EXPECT_THAT(e.what(), ::testing::HasSubstr("fewer lines present"));
+            throw;
+        }
+    });
+
+    // Errors in the preamble still report the line number.
+    EXPECT_ANY_THROW({
+        try {
+            scan("%%MatrixMarket matrix coordinate real general\n%foo\n10 10\n", parse_opt, [&](auto&) -> void {});
+        } catch (std::exception& e) {
+            EXPECT_THAT(e.what(), ::testing::HasSubstr("on line 3"));
+            throw;
+        }
+    });
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    LineTracking,
+    LineTrackingTest,
+    ::testing::Combine(
+        ::testing::Values(1, 2, 3), // number of threads
+        ::testing::Values(1, 20, 65536) // buffer size
+    )
+);
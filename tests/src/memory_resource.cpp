@@ -0,0 +1,186 @@
+#include <gtest/gtest.h>
+
+#include "byteme/byteme.hpp"
+#include "eminem/Parser.hpp"
+#include "eminem/HugePageResource.hpp"
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <memory_resource>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+
+#include "simulate.h"
+#include "format.h"
+
+class CountingResource final : public std::pmr::memory_resource {
+public:
+    std::atomic<int> allocations = 0, outstanding = 0;
+
+private:
+    void* do_allocate(std::size_t bytes, std::size_t alignment) {
+        ++allocations;
+        ++outstanding;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* ptr, std::size_t bytes, std::size_t alignment) {
+        --outstanding;
+        std::pmr::new_delete_resource()->deallocate(ptr, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept {
+        return this == &other;
+    }
+};
+
+class MemoryResourceTest : public ::testing::TestWithParam<int> {
+protected:
+    static std::string simulate_input() {
+        int NR = 89, NC = 67;
+        auto coords = simulate_coordinate(NR, NC, 0.1);
+        auto vals = simulate_real(coords.first.size());
+        std::stringstream stored;
+        format_coordinate(stored, NR, NC, coords.first, coords.second, vals);
+        return stored.str();
+    }
+
+    static std::vector<double> parse(const std::string& input, const eminem::ParserOptions& opt) {
+        auto reader = std::make_unique<byteme::RawBufferReader>(reinterpret_cast<const unsigned char*>(input.data()), input.size());
+        eminem::Parser parser(std::move(reader), opt);
+        parser.scan_preamble();
+        std::vector<double> output;
+        parser.scan_real([&](eminem::Index r, eminem::Index c, double val) -> void {
+            output.push_back(r);
+            output.push_back(c);
+            output.push_back(val);
+        });
+        return output;
+    }
+};
+
+TEST_P(MemoryResourceTest, Custom) {
+    auto input = simulate_input();
+    auto ref = parse(input, {});
+
+    CountingResource counter;
+    eminem::ParserOptions opt;
+    opt.num_threads = GetParam();
+    opt.buffer_size = 100;
+    opt.memory_resource = &counter;
+    EXPECT_EQ(parse(input, opt), ref);
+
+    if (opt.num_threads > 1) {
+        EXPECT_GT(counter.allocations, 0);
+    } else {
+        EXPECT_EQ(counter.allocations, 0);
+    }
+    EXPECT_EQ(counter.outstanding, 0);
+    const int unlimited = counter.allocations;
+
+    // Works with the memory limits.
+    opt.max_inflight_bytes = 1;
+    EXPECT_EQ(parse(input, opt), ref);
+    EXPECT_EQ(counter.outstanding, 0);
+
+    // Helpers that are intermittently left idle by the limit should keep their buffers,
+    // so we shouldn't need more allocations than without the limit.
+    counter.allocations = 0;
+    opt.max_inflight_bytes = 1000;
+    EXPECT_EQ(parse(input, opt), ref);
+    EXPECT_EQ(counter.outstanding, 0);
+    EXPECT_LE(counter.allocations, unlimited);
+}
+
+TEST_P(MemoryResourceTest, Pooled) {
+    auto input = simulate_input();
+    auto ref = parse(input, {});
+
+    CountingResource counter;
+    {
+        std::pmr::synchronized_pool_resource pool(&counter);
+        eminem::ParserOptions opt;
+        opt.num_threads = GetParam();
+        opt.buffer_size = 100;
+        opt.memory_resource = &pool;
+        opt.executor = std::make_shared<eminem::PersistentThreadPool>(2);
+
+        // Same memory resource is used across Parser instances.
+        for (int i = 0; i < 5; ++i) {
+            EXPECT_EQ(parse(input, opt), ref);
+        }
+    }
+
+    EXPECT_EQ(counter.outstanding, 0);
+}
+
+TEST_P(MemoryResourceTest, HugePage) {
+    auto input = simulate_input();
+    auto ref = parse(input, {});
+
+    eminem::HugePageResource hpres(1000);
+    eminem::ParserOptions opt;
+    opt.num_threads = GetParam();
+    opt.buffer_size = 2000;
+    opt.memory_resource = &hpres;
+    EXPECT_EQ(parse(input, opt), ref);
+
+    std::pmr::synchronized_pool_resource pool(&hpres);
+    opt.memory_resource = &pool;
+    EXPECT_EQ(parse(input, opt), ref);
+}
+
+TEST(HugePageResource, Alignment) {
+    eminem::HugePageResource hpres(1000);
+    for (std::size_t alignment : { 16, 4096, 65536, 2097152 }) {
+        for (std::size_t bytes : { 1000, 3000000 }) {
+            void* ptr = hpres.allocate(bytes, alignment);
+            EXPECT_EQ(reinterpret_cast<std::uintptr_t>(ptr) % alignment, 0);
+            std::memset(ptr, 1, bytes);
+            hpres.deallocate(ptr, bytes, alignment);
+        }
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    MemoryResource,
+    MemoryResourceTest,
+    ::testing::Values(1, 2, 3)
+);
+
+TEST(HugePageResource, Basic) {
+    CountingResource counter;
+    eminem::HugePageResource hpres(10000, &counter);
+
+    // Small allocations go to the upstream resource.
+    auto small = static_cast<unsigned char*>(hpres.allocate(100, 8));
+    EXPECT_EQ(counter.outstanding, 1);
+    small[0] = 1;
+    small[99] = 2;
+    hpres.deallocate(small, 100, 8);
+    EXPECT_EQ(counter.outstanding, 0);
+
+    auto large = static_cast<unsigned char*>(hpres.allocate(20000, 64));
+    EXPECT_EQ(reinterpret_cast<std::uintptr_t>(large) % 64, 0);
+    large[0] = 1;
+    large[19999] = 2;
+    hpres.deallocate(large, 20000, 64);
+
+    // Zero-byte allocations always go to the upstream resource.
+    eminem::HugePageResource zero(0, &counter);
+    auto empty = zero.allocate(0, 8);
+    EXPECT_EQ(counter.outstanding, 1);
+    zero.deallocate(empty, 0, 8);
+    EXPECT_EQ(counter.outstanding, 0);
+
+    auto tiny = static_cast<unsigned char*>(zero.allocate(1, 8));
+    EXPECT_EQ(counter.outstanding, 0);
+    tiny[0] = 1;
+    zero.deallocate(tiny, 1, 8);
+
+    EXPECT_TRUE(hpres.is_equal(hpres));
+    eminem::HugePageResource other;
+    EXPECT_FALSE(hpres.is_equal(other));
+}
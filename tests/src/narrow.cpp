@@ -0,0 +1,91 @@
+#include <gtest/gtest.h>
+
+#include "byteme/byteme.hpp"
+#include "eminem/narrow.hpp"
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <type_traits>
+
+template<typename Integer_>
+static int narrowest_bits(Integer_ lower, Integer_ upper, bool& is_signed) {
+    return eminem::dispatch_narrowest_integer(lower, upper, [&](auto x) -> int {
+        is_signed = std::is_signed<decltype(x)>::value;
+        return sizeof(x) * 8;
+    });
+}
+
+TEST(Narrow, Integer) {
+    bool is_signed;
+    EXPECT_EQ(narrowest_bits(0, 0, is_signed), 8);
+    EXPECT_FALSE(is_signed);
+    EXPECT_EQ(narrowest_bits(0, 255, is_signed), 8);
+    EXPECT_EQ(narrowest_bits(0, 256, is_signed), 16);
+    EXPECT_EQ(narrowest_bits(10, 65535, is_signed), 16);
+    EXPECT_EQ(narrowest_bits(10, 65536, is_signed), 32);
+    EXPECT_FALSE(is_signed);
+    EXPECT_EQ(narrowest_bits(0ull, 4294967295ull, is_signed), 32);
+    EXPECT_EQ(narrowest_bits(0ull, 4294967296ull, is_signed), 64);
+    EXPECT_FALSE(is_signed);
+
+    EXPECT_EQ(narrowest_bits(-1, 127, is_signed), 8);
+    EXPECT_TRUE(is_signed);
+    EXPECT_EQ(narrowest_bits(-1, 128, is_signed), 16);
+    EXPECT_EQ(narrowest_bits(-129, 0, is_signed), 16);
+    EXPECT_EQ(narrowest_bits(-32768, 32767, is_signed), 16);
+    EXPECT_EQ(narrowest_bits(-32769, 0, is_signed), 32);
+    EXPECT_EQ(narrowest_bits(std::numeric_limits<long long>::lowest(), 0ll, is_signed), 64);
+    EXPECT_TRUE(is_signed);
+}
+
+TEST(Narrow, Index) {
+    auto check = [](const std::string& input) -> int {
+        auto reader = std::make_unique<byteme::RawBufferReader>(reinterpret_cast<const unsigned char*>(input.data()), input.size());
+        eminem::Parser parser(std::move(reader), {});
+        parser.scan_preamble();
+
+        return eminem::dispatch_narrowest_index(parser, [&](auto x) -> int {
+            typedef decltype(x) Index;
+            static_assert(std::is_unsigned<Index>::value);
+
+            std::vector<Index> rows, cols;
+            parser.scan_integer([&](eminem::Index r, eminem::Index c, int) -> void {
+                rows.push_back(r);
+                cols.push_back(c);
+            });
+            EXPECT_EQ(rows.back(), parser.get_nrows());
+            EXPECT_EQ(cols.back(), parser.get_ncols());
+            return sizeof(Index) * 8;
+        });
+    };
+
+    EXPECT_EQ(check("%%MatrixMarket matrix coordinate integer general\n200 100 2\n1 1 1\n200 100 2\n"), 8);
+    EXPECT_EQ(check("%%MatrixMarket matrix coordinate integer general\n20 1000 2\n1 1 1\n20 1000 2\n"), 16);
+    EXPECT_EQ(check("%%MatrixMarket matrix coordinate integer general\n100000 10 2\n1 1 1\n100000 10 2\n"), 32);
+    EXPECT_EQ(check("%%MatrixMarket matrix coordinate integer general\n10000000000 10 2\n1 1 1\n10000000000 10 2\n"), 64);
+}
+
+TEST(Narrow, ValueRange) {
+    eminem::ValueRange<int> range;
+    EXPECT_TRUE(range.empty());
+    EXPECT_EQ(range.dispatch_narrowest([](auto x) -> int { return sizeof(x); }), 1);
+
+    std::string input = "%%MatrixMarket matrix coordinate integer general\n10 10 4\n1 1 5\n2 2 1000\n3 3 -3\n4 4 20\n";
+    auto reader = std::make_unique<byteme::RawBufferReader>(reinterpret_cast<const unsigned char*>(input.data()), input.size());
+    eminem::Parser parser(std::move(reader), {});
+    parser.scan_preamble();
+    parser.scan_integer([&](eminem::Index, eminem::Index, int v) -> void {
+        range.add(v);
+    });
+
+    EXPECT_FALSE(range.empty());
+    EXPECT_EQ(range.count(), 4);
+    EXPECT_EQ(range.min(), -3);
+    EXPECT_EQ(range.max(), 1000);
+    range.dispatch_narrowest([](auto x) -> void {
+        EXPECT_TRUE(std::is_signed<decltype(x)>::value);
+        EXPECT_EQ(sizeof(x), 2);
+    });
+}
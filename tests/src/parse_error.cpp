@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "byteme/byteme.hpp"
+#include "eminem/Parser.hpp"
+
+#include <string>
+#include <memory>
+
+class ParseErrorTest : public ::testing::TestWithParam<int> {
+protected:
+    eminem::ParserOptions parse_opt;
+
+    void SetUp() {
+        parse_opt.num_threads = GetParam();
+        parse_opt.buffer_size = 10;
+    }
+
+    template<typename Type_ = double>
+    static eminem::ParseError scan(const std::string& input, const eminem::ParserOptions& opt) {
+        auto reader = std::make_unique<byteme::RawBufferReader>(reinterpret_cast<const unsigned char*>(input.data()), input.size());
+        eminem::Parser parser(std::move(reader), opt);
+        try {
+            parser.scan_preamble();
+            if constexpr(std::is_integral<Type_>::value) {
+                parser.scan_integer([&](eminem::Index, eminem::Index, Type_){});
+            } else {
+                parser.scan_real([&](eminem::Index, eminem::Index, Type_){});
+            }
+        } catch (eminem::ParseError& e) {
+            return e;
+        }
+        ADD_FAILURE() << "expected a ParseError";
+        return eminem::ParseError(eminem::ParseErrorCode::INVALID_VALUE, "", false, 0);
+    }
+};
+
+TEST_P(ParseErrorTest, Codes) {
+    std::string header = "%%MatrixMarket matrix coordinate real general\n5 5 3\n1 1 1\n";
+
+    auto err = scan(header + "6 1 1\n2 2 2\n", parse_opt);
+    EXPECT_EQ(err.code(), eminem::ParseErrorCode::INDEX_OUT_OF_RANGE);
+    EXPECT_TRUE(err.is_line());
+    EXPECT_EQ(err.position(), 4);
+    EXPECT_THAT(err.what(), ::testing::HasSubstr("row index out of range on line 4"));
+
+    err = scan(header + "2 2 2\n3 0 1\n", parse_opt);
+    EXPECT_EQ(err.code(), eminem::ParseErrorCode::INDEX_NOT_POSITIVE);
+    EXPECT_EQ(err.position(), 5);
+
+    err = scan(header + "2 2\n3 3 1\n", parse_opt);
+    EXPECT_EQ(err.code(), eminem::ParseErrorCode::MISSING_FIELD);
+    EXPECT_EQ(err.position(), 4);
+
+    err = scan(header + "2 2 2 2\n3 3 1\n", parse_opt);
+    EXPECT_EQ(err.code(), eminem::ParseErrorCode::EXTRA_FIELD);
+
+    err = scan(header + "2 2 \n3 3 1\n", parse_opt);
+    EXPECT_EQ(err.code(), eminem::ParseErrorCode::EMPTY_FIELD);
+
+    err = scan(header + "2 2 0x1\n3 3 1\n", parse_opt);
+    EXPECT_EQ(err.code(), eminem::ParseErrorCode::INVALID_VALUE);
+
+    err = scan(header + "2 a 1\n3 3 1\n", parse_opt);
+    EXPECT_EQ(err.code(), eminem::ParseErrorCode::INVALID_VALUE);
+
+    err = scan<int>("%%MatrixMarket matrix coordinate integer general\n5 5 2\n1 1 1\n2 2 99999999999\n", parse_opt);
+    EXPECT_EQ(err.code(), eminem::ParseErrorCode::VALUE_OVERFLOW);
+    EXPECT_EQ(err.position(), 4);
+
+    // Errors in the size line are also reported.
+    err = scan("%%MatrixMarket matrix coordinate real general\n%foo\n5 5\n", parse_opt);
+    EXPECT_EQ(err.code(), eminem::ParseErrorCode::MISSING_FIELD);
+    EXPECT_EQ(err.position(), 3);
+}
+
+TEST_P(ParseErrorTest, Untracked) {
+    auto opt = parse_opt;
+    opt.track_line_numbers = false;
+
+    std::string prefix = "%%MatrixMarket matrix coordinate real general\n5 5 3\n1 1 1\n2 2 2\n";
+    auto err = scan(prefix + "5 1 1\n6 1 1\n", opt);
+    EXPECT_EQ(err.code(), eminem::ParseErrorCode::INDEX_OUT_OF_RANGE);
+    EXPECT_FALSE(err.is_line());
+    EXPECT_GE(err.position(), prefix.size() + 6);
+    EXPECT_LE(err.position(), prefix.size() + 12);
+    EXPECT_THAT(err.what(), ::testing::HasSubstr("at byte offset " + std::to_string(err.position())));
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    ParseError,
+    ParseErrorTest,
+    ::testing::Values(1, 2, 3) // number of threads
+);
@@ -0,0 +1,180 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "byteme/byteme.hpp"
+#include "eminem/Parser.hpp"
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <random>
+#include <array>
+#include <atomic>
+
+class ParserStatsTest : public ::testing::TestWithParam<std::tuple<int, int, bool> > {
+protected:
+    eminem::ParserOptions parse_opt;
+
+    void SetUp() {
+        auto param = GetParam();
+        parse_opt.num_threads = std::get<0>(param);
+        parse_opt.buffer_size = std::get<1>(param);
+        parse_opt.track_line_numbers = std::get<2>(param);
+    }
+
+    static auto create_parser(const std::string& input, const eminem::ParserOptions& opt) {
+        auto reader = std::make_unique<byteme::RawBufferReader>(reinterpret_cast<const unsigned char*>(input.data()), input.size());
+        return eminem::Parser<decltype(reader), unsigned long long, eminem::ParserStats>(std::move(reader), opt);
+    }
+
+    void check_workers(const eminem::ParserStats& stats) const {
+        if (parse_opt.num_threads == 1) {
+            EXPECT_TRUE(stats.worker_parse_seconds.empty());
+            EXPECT_TRUE(stats.worker_idle_seconds.empty());
+            EXPECT_EQ(stats.count_newlines_seconds, 0);
+            EXPECT_EQ(stats.merge_seconds, 0);
+        } else {
+            EXPECT_EQ(stats.worker_parse_seconds.size(), parse_opt.num_threads);
+            EXPECT_EQ(stats.worker_idle_seconds.size(), parse_opt.num_threads);
+            for (auto x : stats.worker_parse_seconds) {
+                EXPECT_GE(x, 0);
+            }
+            for (auto x : stats.worker_idle_seconds) {
+                EXPECT_GE(x, 0);
+            }
+            if (!parse_opt.track_line_numbers) {
+                EXPECT_EQ(stats.count_newlines_seconds, 0);
+            }
+        }
+
+        EXPECT_GE(stats.extract_seconds, 0);
+        EXPECT_GE(stats.merge_seconds, 0);
+        EXPECT_GE(stats.total_seconds, stats.extract_seconds);
+    }
+};
+
+TEST_P(ParserStatsTest, Coordinate) {
+    std::mt19937_64 rng(99);
+    const int nlines = 1234;
+    std::string preamble = "%%MatrixMarket matrix coordinate integer general\n291 131 " + std::to_string(nlines) + "\n";
+    std::string input = preamble;
+    for (int i = 0; i < nlines; ++i) {
+        if (i % 100 == 0) {
+            input += "%comment\n";
+        }
+        input += std::to_string(rng() % 291 + 1) + " " + std::to_string(rng() % 131 + 1) + " " + std::to_string(static_cast<int>(rng() % 1999) - 999) + "\n";
+    }
+
+    auto parser = create_parser(input, parse_opt);
+    parser.scan_preamble();
+    std::size_t count = 0;
+    parser.scan_integer([&](eminem::Index, eminem::Index, int) -> void { ++count; });
+
+    const auto& stats = parser.get_stats();
+    EXPECT_EQ(stats.lines_parsed, nlines);
+    EXPECT_EQ(count, nlines);
+    EXPECT_EQ(stats.bytes_read, input.size() - preamble.size());
+    check_workers(stats);
+}
+
+TEST_P(ParserStatsTest, Array) {
+    const int NR = 52, NC = 97;
+    std::string preamble = "%%MatrixMarket matrix array real general\n" + std::to_string(NR) + " " + std::to_string(NC) + "\n";
+    std::string input = preamble;
+    for (int i = 0; i < NR * NC; ++i) {
+        input += std::to_string(i / 7.0) + "\n";
+    }
+
+    auto parser = create_parser(input, parse_opt);
+    parser.scan_preamble();
+    parser.scan_real([&](eminem::Index, eminem::Index, double) -> void {});
+
+    const auto& stats = parser.get_stats();
+    EXPECT_EQ(stats.lines_parsed, NR * NC);
+    EXPECT_EQ(stats.bytes_read, input.size() - preamble.size());
+    check_workers(stats);
+}
+
+TEST_P(ParserStatsTest, EarlyQuit) {
+    const int N = 1000;
+    std::string preamble = "%%MatrixMarket vector coordinate pattern general\n" + std::to_string(N) + " " + std::to_string(N) + "\n";
+    std::string input = preamble;
+    for (int i = 1; i <= N; ++i) {
+        input += std::to_string(i) + "\n";
+    }
+
+    auto parser = create_parser(input, parse_opt);
+    parser.scan_preamble();
+    std::size_t count = 0;
+    EXPECT_FALSE(parser.scan_pattern([&](eminem::Index, eminem::Index, bool) -> bool {
+        ++count;
+        return count < 10;
+    }));
+
+    const auto& stats = parser.get_stats();
+    EXPECT_EQ(stats.lines_parsed, 10);
+    EXPECT_LE(stats.bytes_read, input.size() - preamble.size());
+    check_workers(stats);
+}
+
+// Counting the start and end of each phase, as a stand-in for collecting hardware counters.
+struct PhaseStats : public eminem::ParserStats {
+    static constexpr int num_phases = 5;
+    std::array<std::atomic<int>, num_phases> starts{}, ends{};
+
+    void start_phase(eminem::ParserPhase phase) {
+        ++starts[static_cast<int>(phase)];
+    }
+
+    void end_phase(eminem::ParserPhase phase) {
+        ++ends[static_cast<int>(phase)];
+    }
+};
+
+TEST_P(ParserStatsTest, Phases) {
+    const int N = 500;
+    std::string preamble = "%%MatrixMarket vector coordinate integer general\n" + std::to_string(N) + " " + std::to_string(N) + "\n";
+    std::string input = preamble;
+    for (int i = 1; i <= N; ++i) {
+        input += std::to_string(i) + " " + std::to_string(i * 2) + "\n";
+    }
+
+    auto reader = std::make_unique<byteme::RawBufferReader>(reinterpret_cast<const unsigned char*>(input.data()), input.size());
+    eminem::Parser<decltype(reader), unsigned long long, PhaseStats> parser(std::move(reader), parse_opt);
+    parser.scan_preamble();
+    parser.scan_integer([&](eminem::Index, eminem::Index, int) -> void {});
+
+    const auto& stats = parser.get_stats();
+    EXPECT_EQ(stats.lines_parsed, N);
+    check_workers(stats);
+
+    for (int p = 0; p < PhaseStats::num_phases; ++p) {
+        EXPECT_EQ(stats.starts[p].load(), stats.ends[p].load());
+    }
+    auto count = [&](eminem::ParserPhase phase) -> int {
+        return stats.starts[static_cast<int>(phase)].load();
+    };
+
+    EXPECT_EQ(count(eminem::ParserPhase::SCAN), 1);
+    EXPECT_GT(count(eminem::ParserPhase::EXTRACT), 0);
+    if (parse_opt.num_threads == 1) {
+        EXPECT_EQ(count(eminem::ParserPhase::PARSE), 0);
+        EXPECT_EQ(count(eminem::ParserPhase::MERGE), 0);
+        EXPECT_EQ(count(eminem::ParserPhase::COUNT_NEWLINES), 0);
+    } else {
+        // Each chunk is extracted, parsed and merged exactly once.
+        EXPECT_EQ(count(eminem::ParserPhase::PARSE), count(eminem::ParserPhase::EXTRACT));
+        EXPECT_EQ(count(eminem::ParserPhase::MERGE), count(eminem::ParserPhase::EXTRACT));
+        EXPECT_EQ(count(eminem::ParserPhase::COUNT_NEWLINES), parse_opt.track_line_numbers ? count(eminem::ParserPhase::EXTRACT) : 0);
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    ParserStats,
+    ParserStatsTest,
+    ::testing::Combine(
+        ::testing::Values(1, 2, 3), // number of threads
+        ::testing::Values(10, 100, 1000), // buffer size
+        ::testing::Values(true, false) // whether to track line numbers
+    )
+);
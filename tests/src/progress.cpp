@@ -0,0 +1,140 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "byteme/byteme.hpp"
+#include "eminem/Parser.hpp"
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <random>
+#include <stdexcept>
+
+class ProgressTest : public ::testing::TestWithParam<std::tuple<int, int> > {
+protected:
+    eminem::ParserOptions parse_opt;
+    std::vector<eminem::ParserProgress> history;
+
+    void SetUp() {
+        auto param = GetParam();
+        parse_opt.num_threads = std::get<0>(param);
+        parse_opt.buffer_size = std::get<1>(param);
+        parse_opt.progress = [&](const eminem::ParserProgress& prog) -> void {
+            history.push_back(prog);
+        };
+    }
+
+    static std::string simulate(int nlines) {
+        std::mt19937_64 rng(nlines);
+        std::string output = "%%MatrixMarket matrix coordinate real general\n1000 500 " + std::to_string(nlines) + "\n";
+        for (int i = 0; i < nlines; ++i) {
+            output += std::to_string(rng() % 1000 + 1) + " " + std::to_string(rng() % 500 + 1) + " " + std::to_string(static_cast<double>(rng() % 1000) / 10) + "\n";
+        }
+        return output;
+    }
+
+    template<class Function_>
+    static void scan(const std::string& input, const eminem::ParserOptions& opt, Function_ fun) {
+        auto reader = std::make_unique<byteme::RawBufferReader>(reinterpret_cast<const unsigned char*>(input.data()), input.size());
+        eminem::Parser parser(std::move(reader), opt);
+        parser.scan_preamble();
+        fun(parser);
+    }
+
+    void check_monotonic() const {
+        for (std::size_t i = 1; i < history.size(); ++i) {
+            EXPECT_GE(history[i].bytes_consumed, history[i - 1].bytes_consumed);
+            EXPECT_GE(history[i].lines_parsed, history[i - 1].lines_parsed);
+        }
+    }
+};
+
+TEST_P(ProgressTest, Basic) {
+    const int nlines = 20000;
+    auto input = simulate(nlines);
+    parse_opt.progress_interval = 100000;
+
+    scan(input, parse_opt, [&](auto& parser) -> void {
+        parser.scan_real([&](eminem::Index, eminem::Index, double) -> void {});
+    });
+
+    ASSERT_GT(history.size(), 1);
+    check_monotonic();
+    for (const auto& prog : history) {
+        EXPECT_EQ(prog.expected_lines, nlines);
+        EXPECT_LE(prog.bytes_consumed, input.size());
+    }
+    EXPECT_EQ(history.back().lines_parsed, nlines);
+    EXPECT_EQ(history.back().bytes_consumed, input.size());
+
+    if (parse_opt.num_threads == 1) {
+        // Reports are throttled, except for the final one.
+        for (std::size_t i = 1; i + 1 < history.size(); ++i) {
+            EXPECT_GE(history[i].bytes_consumed - history[i - 1].bytes_consumed, parse_opt.progress_interval);
+        }
+    }
+}
+
+TEST_P(ProgressTest, EarlyQuit) {
+    const int nlines = 20000;
+    auto input = simulate(nlines);
+    parse_opt.progress_interval = 0;
+
+    int counter = 0;
+    scan(input, parse_opt, [&](auto& parser) -> void {
+        parser.scan_real([&](eminem::Index, eminem::Index, double) -> bool {
+            ++counter;
+            return counter < 10000;
+        });
+    });
+
+    check_monotonic();
+    for (const auto& prog : history) {
+        EXPECT_LT(prog.lines_parsed, 10000);
+    }
+}
+
+TEST_P(ProgressTest, StoreFailure) {
+    const int nlines = 20000;
+    auto input = simulate(nlines);
+    parse_opt.progress_interval = 0;
+
+    // Failing on a multiple of the serial check interval, so that a report would have been due for the failed line.
+    int stored = 0;
+    EXPECT_ANY_THROW({
+        scan(input, parse_opt, [&](auto& parser) -> void {
+            parser.scan_real([&](eminem::Index, eminem::Index, double) -> void {
+                if (stored + 1 == 8192) {
+                    throw std::runtime_error("failed to store");
+                }
+                ++stored;
+            });
+        });
+    });
+
+    EXPECT_EQ(stored, 8191);
+    check_monotonic();
+    for (const auto& prog : history) {
+        EXPECT_LE(prog.lines_parsed, stored);
+    }
+}
+
+TEST_P(ProgressTest, Unset) {
+    parse_opt.progress = std::function<void(const eminem::ParserProgress&)>();
+    auto input = simulate(1000);
+    int counter = 0;
+    scan(input, parse_opt, [&](auto& parser) -> void {
+        parser.scan_real([&](eminem::Index, eminem::Index, double) -> void { ++counter; });
+    });
+    EXPECT_EQ(counter, 1000);
+    EXPECT_TRUE(history.empty());
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Progress,
+    ProgressTest,
+    ::testing::Combine(
+        ::testing::Values(1, 2, 3), // number of threads
+        ::testing::Values(100, 10000) // buffer size
+    )
+);
@@ -168,6 +168,73 @@ TEST(ParserReal, OtherTypes) {
     }
 }
 
+TEST(ParserReal, SinglePrecision) {
+    // Checking that direct parsing in single precision is correctly rounded, by comparing to strtof().
+    std::vector<std::string> values {
+        "0.1", "+0.1", "-0.1", "1", "1.", ".5", "3.4028235e38", "1.17549435e-38", "1e-45", "16777217", "1.00000005960464477539", 
+        "123456789012345678901234567890", "0.000000000000000000000000000001234567", "2.5e+10", "-7.E-3", "+INF", "-infinity"
+    };
+
+    std::string input = "%%MatrixMarket matrix coordinate real general\n10 10 " + std::to_string(values.size()) + "\n";
+    for (const auto& v : values) {
+        input += "1 1 " + v + "\n";
+    }
+
+    auto reader = std::make_unique<byteme::RawBufferReader>(reinterpret_cast<const unsigned char*>(input.data()), input.size()); 
+    eminem::Parser parser(std::move(reader), {});
+    parser.scan_preamble();
+
+    std::vector<float> observed;
+    EXPECT_TRUE(parser.template scan_real<float>([&](eminem::Index, eminem::Index, float val) {
+        observed.push_back(val);
+    }));
+    ASSERT_EQ(observed.size(), values.size());
+    for (std::size_t i = 0; i < values.size(); ++i) {
+        EXPECT_EQ(observed[i], std::strtof(values[i].c_str(), NULL)) << values[i];
+    }
+
+    auto test_float_error = [](const std::string& value, const std::string& msg) -> void {
+        std::string input = "%%MatrixMarket matrix coordinate real general\n10 10 1\n1 1 " + value + "\n";
+        auto reader = std::make_unique<byteme::RawBufferReader>(reinterpret_cast<const unsigned char*>(input.data()), input.size()); 
+        eminem::Parser parser(std::move(reader), {});
+        parser.scan_preamble();
+        EXPECT_ANY_THROW({
+            try {
+                parser.template scan_real<float>([&](eminem::Index, eminem::Index, float){});
+            } catch (std::exception& e) {
+                EXPECT_THAT(e.what(), ::testing::HasSubstr(msg));
+                throw;
+            }
+        });
+    };
+
+    test_float_error("+-1", "failed to convert");
+    test_float_error("++1", "failed to convert");
+    test_float_error("+", "failed to convert");
+    test_float_error("1.5x", "failed to convert");
+    test_float_error("1e", "failed to convert");
+
+    // Signed hexadecimal floats are still accepted, as they were by std::stof().
+    {
+        std::string input = "%%MatrixMarket matrix coordinate real general\n10 10 1\n1 1 -0x1p3\n";
+        auto reader = std::make_unique<byteme::RawBufferReader>(reinterpret_cast<const unsigned char*>(input.data()), input.size()); 
+        eminem::Parser parser(std::move(reader), {});
+        parser.scan_preamble();
+        float observed = 0;
+        EXPECT_TRUE(parser.template scan_real<float>([&](eminem::Index, eminem::Index, float val){ observed = val; }));
+        EXPECT_EQ(observed, -8);
+    }
+
+    // Out-of-range values are handled in the same way as std::stof().
+    {
+        std::string input = "%%MatrixMarket matrix coordinate real general\n10 10 1\n1 1 1e50\n";
+        auto reader = std::make_unique<byteme::RawBufferReader>(reinterpret_cast<const unsigned char*>(input.data()), input.size()); 
+        eminem::Parser parser(std::move(reader), {});
+        parser.scan_preamble();
+        EXPECT_THROW(parser.template scan_real<float>([&](eminem::Index, eminem::Index, float){}), std::out_of_range);
+    }
+}
+
 TEST(ParserReal, Specials) {
     for (int i = 0; i < 3; ++i) {
         std::string input = "%%MatrixMarket matrix coordinate real general\n10 10 4\n";
@@ -242,6 +309,78 @@ TEST(ParserReal, QuitEarly) {
     EXPECT_EQ(observed, expected);
 }
 
+class ParserRealIntegralTest : public ::testing::TestWithParam<int> {
+protected:
+    template<typename Type_ = double>
+    std::pair<std::vector<Type_>, bool> scan(const std::string& input) {
+        eminem::ParserOptions opt;
+        opt.num_threads = GetParam();
+        opt.buffer_size = 20;
+        auto reader = std::make_unique<byteme::RawBufferReader>(reinterpret_cast<const unsigned char*>(input.data()), input.size()); 
+        eminem::Parser parser(std::move(reader), opt);
+        parser.scan_preamble();
+
+        std::vector<Type_> observed;
+        EXPECT_TRUE(parser.template scan_real<Type_>([&](eminem::Index, eminem::Index, Type_ val) {
+            observed.push_back(val);
+        }));
+        return std::make_pair(std::move(observed), parser.get_all_integral());
+    }
+};
+
+TEST_P(ParserRealIntegralTest, Basic) {
+    std::vector<std::string> values { "0", "1", "-1", "+42", "007", "-0", "123456789012345", "9999999999999999", "12345678901234567890123" };
+    std::string coord = "%%MatrixMarket matrix coordinate real general\n10 10 " + std::to_string(values.size()) + "\n";
+    std::string array = "%%MatrixMarket vector array real\n" + std::to_string(values.size()) + "\n";
+    for (const auto& v : values) {
+        coord += "1 1 " + v + "\n";
+        array += v + "\n";
+    }
+
+    for (const auto& input : { coord, array }) {
+        auto res = scan(input);
+        EXPECT_TRUE(res.second);
+        ASSERT_EQ(res.first.size(), values.size());
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            EXPECT_EQ(res.first[i], std::stod(values[i])) << values[i];
+            EXPECT_EQ(std::signbit(res.first[i]), std::signbit(std::stod(values[i])));
+        }
+
+        auto fres = scan<float>(input);
+        EXPECT_TRUE(fres.second);
+        for (std::size_t i = 0; i < values.size(); ++i) {
+            EXPECT_EQ(fres.first[i], std::stof(values[i])) << values[i];
+        }
+    }
+
+    // Any non-integer token is detected.
+    for (std::string extra : { "1.0", "1e5", "inf", "nan", ".5" }) {
+        auto res = scan("%%MatrixMarket matrix coordinate real general\n10 10 3\n1 1 5\n2 2 " + extra + "\n3 3 -2\n");
+        EXPECT_FALSE(res.second);
+        ASSERT_EQ(res.first.size(), 3);
+        EXPECT_EQ(res.first[0], 5);
+        EXPECT_EQ(res.first[2], -2);
+    }
+
+    // Complex values are also considered.
+    {
+        eminem::ParserOptions opt;
+        opt.num_threads = GetParam();
+        std::string input = "%%MatrixMarket matrix coordinate complex general\n10 10 2\n1 1 5 -3\n2 2 1 2.5\n";
+        auto reader = std::make_unique<byteme::RawBufferReader>(reinterpret_cast<const unsigned char*>(input.data()), input.size()); 
+        eminem::Parser parser(std::move(reader), opt);
+        parser.scan_preamble();
+        parser.scan_complex([&](eminem::Index, eminem::Index, std::complex<double>) {});
+        EXPECT_FALSE(parser.get_all_integral());
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    ParserReal,
+    ParserRealIntegralTest,
+    ::testing::Values(1, 2, 3) // number of threads
+);
+
 class ParserRealSimulatedTest : public ::testing::TestWithParam<std::tuple<int, int> > {
 protected:
     eminem::ParserOptions parse_opt;
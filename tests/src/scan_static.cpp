@@ -0,0 +1,213 @@
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include "byteme/byteme.hpp"
+#include "eminem/Parser.hpp"
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <complex>
+#include <cstdint>
+
+#include "simulate.h"
+#include "format.h"
+
+class ScanStaticTest : public ::testing::TestWithParam<int> {
+protected:
+    eminem::ParserOptions parse_opt;
+
+    void SetUp() {
+        parse_opt.num_threads = GetParam();
+        parse_opt.buffer_size = 100;
+    }
+
+    auto create_parser(const std::string& input) const {
+        auto reader = std::make_unique<byteme::RawBufferReader>(reinterpret_cast<const unsigned char*>(input.data()), input.size()); 
+        eminem::Parser parser(std::move(reader), parse_opt);
+        parser.scan_preamble();
+        return parser;
+    }
+
+    template<typename Value_, class Scan_>
+    static auto collect(Scan_ scan) {
+        std::vector<int> out_rows, out_cols;
+        std::vector<Value_> out_vals;
+        bool success = scan([&](eminem::Index r, eminem::Index c, Value_ v) -> void {
+            out_rows.push_back(r);
+            out_cols.push_back(c);
+            out_vals.push_back(v);
+        });
+        EXPECT_TRUE(success);
+        return std::make_tuple(std::move(out_rows), std::move(out_cols), std::move(out_vals));
+    }
+};
+
+TEST_P(ScanStaticTest, CoordinateMatrixInteger) {
+    std::size_t NR = 65, NC = 58;
+    auto coords = simulate_coordinate(NR, NC, 0.1);
+    auto values = simulate_integer(coords.first.size(), -999, 999);
+    std::stringstream stored;
+    format_coordinate(stored, NR, NC, coords.first, coords.second, values);
+    std::string input = stored.str();
+
+    auto ref_parser = create_parser(input);
+    auto ref = collect<int>([&](auto fun) -> bool { return ref_parser.scan_integer(fun); });
+
+    auto parser = create_parser(input);
+    auto obs = collect<int>([&](auto fun) -> bool { 
+        return parser.template scan_static<eminem::Object::MATRIX, eminem::Format::COORDINATE, eminem::Field::INTEGER>(fun); 
+    });
+    EXPECT_EQ(ref, obs);
+    EXPECT_EQ(std::get<2>(obs), values);
+
+    // Works with other types.
+    auto parser2 = create_parser(input);
+    std::vector<std::int16_t> obs2;
+    parser2.template scan_static<eminem::Object::MATRIX, eminem::Format::COORDINATE, eminem::Field::INTEGER, std::int16_t>([&](eminem::Index, eminem::Index, std::int16_t v) -> void {
+        obs2.push_back(v);
+    });
+    EXPECT_EQ(std::vector<int>(obs2.begin(), obs2.end()), values);
+}
+
+TEST_P(ScanStaticTest, CoordinateVectorReal) {
+    std::size_t N = 1234;
+    auto coords = simulate_coordinate(N, 0.1);
+    auto values = simulate_real(coords.size());
+    std::stringstream stored;
+    format_coordinate(stored, N, coords, values);
+    std::string input = stored.str();
+
+    auto ref_parser = create_parser(input);
+    auto ref = collect<double>([&](auto fun) -> bool { return ref_parser.scan_real(fun); });
+
+    auto parser = create_parser(input);
+    auto obs = collect<double>([&](auto fun) -> bool { 
+        return parser.template scan_static<eminem::Object::VECTOR, eminem::Format::COORDINATE, eminem::Field::REAL>(fun); 
+    });
+    EXPECT_EQ(ref, obs);
+
+    // Real and double are interchangeable. 
+    auto parser2 = create_parser(input);
+    auto obs2 = collect<double>([&](auto fun) -> bool { 
+        return parser2.template scan_static<eminem::Object::VECTOR, eminem::Format::COORDINATE, eminem::Field::DOUBLE>(fun); 
+    });
+    EXPECT_EQ(ref, obs2);
+}
+
+TEST_P(ScanStaticTest, ArrayMatrixComplex) {
+    std::size_t NR = 23, NC = 31;
+    auto values = simulate_complex(NR * NC);
+    std::stringstream stored;
+    format_array(stored, NR, NC, values);
+    std::string input = stored.str();
+
+    auto ref_parser = create_parser(input);
+    auto ref = collect<std::complex<double> >([&](auto fun) -> bool { return ref_parser.scan_complex(fun); });
+
+    auto parser = create_parser(input);
+    auto obs = collect<std::complex<double> >([&](auto fun) -> bool { 
+        return parser.template scan_static<eminem::Object::MATRIX, eminem::Format::ARRAY, eminem::Field::COMPLEX>(fun); 
+    });
+    EXPECT_EQ(ref, obs);
+}
+
+TEST_P(ScanStaticTest, ArrayVectorInteger) {
+    std::size_t N = 500;
+    auto values = simulate_integer(N, -10, 10);
+    std::stringstream stored;
+    format_array(stored, N, values);
+    std::string input = stored.str();
+
+    auto ref_parser = create_parser(input);
+    auto ref = collect<int>([&](auto fun) -> bool { return ref_parser.scan_integer(fun); });
+
+    auto parser = create_parser(input);
+    auto obs = collect<int>([&](auto fun) -> bool { 
+        return parser.template scan_static<eminem::Object::VECTOR, eminem::Format::ARRAY, eminem::Field::INTEGER>(fun); 
+    });
+    EXPECT_EQ(ref, obs);
+}
+
+TEST_P(ScanStaticTest, Pattern) {
+    {
+        std::size_t NR = 65, NC = 58;
+        auto coords = simulate_coordinate(NR, NC, 0.1);
+        std::stringstream stored;
+        format_coordinate(stored, NR, NC, coords.first, coords.second, std::vector<char>());
+        std::string input = stored.str();
+
+        auto ref_parser = create_parser(input);
+        auto ref = collect<bool>([&](auto fun) -> bool { return ref_parser.scan_pattern(fun); });
+
+        auto parser = create_parser(input);
+        auto obs = collect<bool>([&](auto fun) -> bool { 
+            return parser.template scan_static<eminem::Object::MATRIX, eminem::Format::COORDINATE, eminem::Field::PATTERN>(fun); 
+        });
+        EXPECT_EQ(ref, obs);
+    }
+
+    {
+        std::size_t N = 1234;
+        auto coords = simulate_coordinate(N, 0.1);
+        std::stringstream stored;
+        format_coordinate(stored, N, coords, std::vector<char>());
+        std::string input = stored.str();
+
+        auto ref_parser = create_parser(input);
+        auto ref = collect<bool>([&](auto fun) -> bool { return ref_parser.scan_pattern(fun); });
+
+        auto parser = create_parser(input);
+        auto obs = collect<bool>([&](auto fun) -> bool { 
+            return parser.template scan_static<eminem::Object::VECTOR, eminem::Format::COORDINATE, eminem::Field::PATTERN>(fun); 
+        });
+        EXPECT_EQ(ref, obs);
+    }
+}
+
+TEST_P(ScanStaticTest, QuitEarly) {
+    std::string input = "%%MatrixMarket matrix coordinate integer general\n10 10 3\n1 2 33\n4 5 666\n7 8 9\n";
+    auto parser = create_parser(input);
+    std::vector<int> observed;
+    EXPECT_FALSE((parser.template scan_static<eminem::Object::MATRIX, eminem::Format::COORDINATE, eminem::Field::INTEGER>([&](eminem::Index, eminem::Index, int val) -> bool {
+        observed.push_back(val);
+        return false;
+    })));
+    std::vector<int> expected { 33 };
+    EXPECT_EQ(observed, expected);
+}
+
+TEST_P(ScanStaticTest, Mismatch) {
+    std::string input = "%%MatrixMarket matrix coordinate integer general\n10 10 3\n1 2 33\n4 5 666\n7 8 9\n";
+
+    auto check_error = [&](auto scan, const std::string& msg) -> void {
+        auto parser = create_parser(input);
+        EXPECT_ANY_THROW({
+            try {
+                scan(parser);
+            } catch (std::exception& e) {
+                EXPECT_THAT(e.what(), ::testing::HasSubstr(msg));
+                throw;
+            }
+        });
+    };
+
+    check_error([](auto& parser) -> void {
+        parser.template scan_static<eminem::Object::VECTOR, eminem::Format::COORDINATE, eminem::Field::INTEGER>([](eminem::Index, eminem::Index, int) -> void {});
+    }, "expected object");
+    check_error([](auto& parser) -> void {
+        parser.template scan_static<eminem::Object::MATRIX, eminem::Format::ARRAY, eminem::Field::INTEGER>([](eminem::Index, eminem::Index, int) -> void {});
+    }, "expected format");
+    check_error([](auto& parser) -> void {
+        parser.template scan_static<eminem::Object::MATRIX, eminem::Format::COORDINATE, eminem::Field::REAL>([](eminem::Index, eminem::Index, double) -> void {});
+    }, "expected field");
+    check_error([](auto& parser) -> void {
+        parser.template scan_static<eminem::Object::MATRIX, eminem::Format::COORDINATE, eminem::Field::PATTERN>([](eminem::Index, eminem::Index, bool) -> void {});
+    }, "expected field");
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    ScanStatic,
+    ScanStaticTest,
+    ::testing::Values(1, 3)
+);
@@ -0,0 +1,113 @@
+#include <gtest/gtest.h>
+
+#include "byteme/byteme.hpp"
+#include "eminem/Parser.hpp"
+
+#include <string>
+#include <memory>
+#include <vector>
+#include <random>
+#include <algorithm>
+
+#include "simulate.h"
+#include "format.h"
+
+// Returns fewer bytes than requested to check that the SourceReader can handle short reads.
+class TrickleReader final : public byteme::Reader {
+public:
+    TrickleReader(const std::string& contents) : my_contents(contents) {}
+
+    std::size_t read(unsigned char* buffer, std::size_t n) {
+        n = std::min(n, std::min(static_cast<std::size_t>(7), my_contents.size() - my_position));
+        std::copy_n(my_contents.data() + my_position, n, buffer);
+        my_position += n;
+        return n;
+    }
+
+private:
+    std::string my_contents;
+    std::size_t my_position = 0;
+};
+
+class SourceReaderTest : public ::testing::TestWithParam<int> {
+protected:
+    std::string contents;
+
+    void SetUp() {
+        std::mt19937_64 rng(42);
+        for (int i = 0; i < 1000; ++i) {
+            contents += static_cast<char>('a' + rng() % 26);
+        }
+    }
+
+    template<class Reader_>
+    std::string consume(Reader_& reader, std::size_t seed) {
+        std::mt19937_64 rng(seed);
+        std::string output;
+        std::vector<char> buffer;
+
+        bool valid = reader.valid();
+        while (valid) {
+            if (rng() % 2) {
+                output += reader.get();
+                valid = reader.advance();
+            } else {
+                std::size_t n = rng() % 100 + 1;
+                buffer.resize(n);
+                auto done = reader.extract(n, buffer.data());
+                output.insert(output.end(), buffer.begin(), buffer.begin() + done.first);
+                EXPECT_TRUE(done.first == n || !done.second);
+                EXPECT_EQ(done.second, reader.valid());
+                valid = done.second;
+            }
+            EXPECT_EQ(reader.position(), output.size());
+        }
+
+        return output;
+    }
+};
+
+TEST_P(SourceReaderTest, Basic) {
+    auto bufsize = GetParam();
+    for (int seed = 0; seed < 10; ++seed) {
+        auto reader = std::make_unique<byteme::RawBufferReader>(reinterpret_cast<const unsigned char*>(contents.data()), contents.size());
+        eminem::SourceReader<decltype(reader)> src(std::move(reader), bufsize);
+        EXPECT_EQ(consume(src, seed), contents);
+    }
+}
+
+TEST_P(SourceReaderTest, Trickle) {
+    auto bufsize = GetParam();
+    for (int seed = 0; seed < 10; ++seed) {
+        auto reader = std::make_unique<TrickleReader>(contents);
+        eminem::SourceReader<decltype(reader)> src(std::move(reader), bufsize);
+        EXPECT_EQ(consume(src, seed), contents);
+    }
+}
+
+TEST_P(SourceReaderTest, Parse) {
+    int NR = 78, NC = 56;
+    auto coords = simulate_coordinate(NR, NC, 0.1);
+    auto vals = simulate_integer(coords.first.size(), -100, 100);
+    std::stringstream stored;
+    format_coordinate(stored, NR, NC, coords.first, coords.second, vals);
+    auto input = stored.str();
+
+    eminem::ParserOptions opt;
+    opt.num_threads = 3;
+    opt.buffer_size = GetParam();
+    eminem::Parser parser(std::make_unique<TrickleReader>(input), opt);
+    parser.scan_preamble();
+
+    std::vector<int> out_vals;
+    parser.scan_integer([&](eminem::Index, eminem::Index, int v) -> void {
+        out_vals.push_back(v);
+    });
+    EXPECT_EQ(out_vals, vals);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    SourceReader,
+    SourceReaderTest,
+    ::testing::Values(1, 10, 50, 500, 5000)
+);
@@ -0,0 +1,162 @@
+#include <gtest/gtest.h>
+
+#include "eminem/to_gzip.hpp"
+#include "eminem/to_text.hpp"
+#include "eminem/from_gzip.hpp"
+
+#include "temp_file_path.h"
+#include "simulate.h"
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iterator>
+#include <cstring>
+
+static std::string read_gzip(const std::string& path) {
+    gzFile handle = gzopen(path.c_str(), "rb");
+    std::string output;
+    std::vector<char> buffer(10000);
+    while (1) {
+        const int got = gzread(handle, buffer.data(), buffer.size());
+        if (got <= 0) {
+            break;
+        }
+        output.append(buffer.data(), got);
+    }
+    gzclose(handle);
+    return output;
+}
+
+static std::size_t count_members(const std::string& path) {
+    std::ifstream handle(path, std::ios::binary);
+    std::string contents((std::istreambuf_iterator<char>(handle)), std::istreambuf_iterator<char>());
+
+    z_stream stream;
+    std::memset(&stream, 0, sizeof(z_stream));
+    inflateInit2(&stream, 15 + 16);
+    std::vector<unsigned char> buffer(10000);
+    stream.next_in = reinterpret_cast<unsigned char*>(contents.data());
+    stream.avail_in = contents.size();
+
+    std::size_t nmembers = 0;
+    while (stream.avail_in) {
+        stream.next_out = buffer.data();
+        stream.avail_out = buffer.size();
+        const int res = inflate(&stream, Z_NO_FLUSH);
+        if (res == Z_STREAM_END) {
+            ++nmembers;
+            inflateReset(&stream);
+        } else if (res != Z_OK) {
+            break;
+        }
+    }
+    inflateEnd(&stream);
+    return nmembers;
+}
+
+class ToGzipTest : public ::testing::TestWithParam<std::tuple<int, int> > {};
+
+TEST_P(ToGzipTest, Basic) {
+    std::size_t NR = 192, NC = 132;
+    auto coords = simulate_coordinate(NR, NC, 0.1);
+    auto values = simulate_real(coords.first.size());
+
+    std::vector<unsigned long long> rows, cols;
+    for (auto r : coords.first) {
+        rows.push_back(r + 1);
+    }
+    for (auto c : coords.second) {
+        cols.push_back(c + 1);
+    }
+    const eminem::MatrixDetails details{ eminem::Object::MATRIX, eminem::Format::COORDINATE, eminem::Field::REAL, eminem::Symmetry::GENERAL };
+
+    auto param = GetParam();
+    eminem::GzipSinkOptions gopt;
+    gopt.num_threads = std::get<0>(param);
+    gopt.block_size = std::get<1>(param);
+
+    auto path = temp_file_path("to_gzip");
+    {
+        eminem::Writer<std::unique_ptr<eminem::GzipSink> > writer(std::make_unique<eminem::GzipSink>(path.c_str(), gopt), {});
+        writer.write_preamble(details, NR, NC, values.size());
+        writer.write_coordinate(values.size(), rows.data(), cols.data(), values.data());
+        writer.finish();
+    }
+
+    // Decompressed contents should be the same as the uncompressed output.
+    auto ref = eminem::write_text_buffer({});
+    ref.write_preamble(details, NR, NC, values.size());
+    ref.write_coordinate(values.size(), rows.data(), cols.data(), values.data());
+    ref.finish();
+    const auto& expected = ref.get_sink()->get_contents();
+    EXPECT_EQ(read_gzip(path), std::string(expected.begin(), expected.end()));
+
+    const std::size_t expected_members = (expected.size() + gopt.block_size - 1) / gopt.block_size;
+    EXPECT_EQ(count_members(path), expected_members);
+
+    auto parser = eminem::parse_gzip_file(path.c_str(), {});
+    parser.scan_preamble();
+    EXPECT_EQ(parser.get_nlines(), values.size());
+    std::vector<double> out_vals;
+    parser.scan_real([&](unsigned long long, unsigned long long, double v) -> void {
+        out_vals.push_back(v);
+    });
+    EXPECT_EQ(out_vals, values);
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    ToGzip,
+    ToGzipTest,
+    ::testing::Combine(
+        ::testing::Values(1, 2, 3), // number of threads
+        ::testing::Values(100, 1000, 1048576) // block size
+    )
+);
+
+TEST(ToGzip, WriteGzipFile) {
+    std::size_t N = 5000;
+    auto values = simulate_integer(N, -100, 100);
+
+    for (int nthreads : { 1, 3 }) {
+        auto path = temp_file_path("to_gzip");
+        {
+            eminem::WriterOptions opt;
+            opt.num_threads = nthreads;
+            opt.chunk_lines = 500;
+            auto writer = eminem::write_gzip_file(path.c_str(), opt, 9);
+            writer.write_preamble({ eminem::Object::VECTOR, eminem::Format::ARRAY, eminem::Field::INTEGER, eminem::Symmetry::GENERAL }, N, 1, 0);
+            writer.write_array(values.size(), values.data());
+            writer.finish();
+        }
+
+        auto parser = eminem::parse_some_file(path.c_str(), {});
+        parser.scan_preamble();
+        std::vector<int> out_vals;
+        parser.scan_integer([&](unsigned long long, unsigned long long, int v) -> void {
+            out_vals.push_back(v);
+        });
+        EXPECT_EQ(out_vals, values);
+    }
+}
+
+TEST(ToGzip, Empty) {
+    auto path = temp_file_path("to_gzip");
+    {
+        eminem::GzipSink sink(path.c_str(), {});
+        sink.finish();
+    }
+    EXPECT_EQ(count_members(path), 1);
+    EXPECT_EQ(read_gzip(path), "");
+}
+
+TEST(ToGzip, Errors) {
+    auto path = temp_file_path("to_gzip");
+    eminem::GzipSinkOptions gopt;
+    gopt.block_size = 0;
+    EXPECT_ANY_THROW(eminem::GzipSink(path.c_str(), gopt));
+
+    gopt.block_size = 100;
+    gopt.compression_level = 10;
+    EXPECT_ANY_THROW(eminem::GzipSink(path.c_str(), gopt));
+}
@@ -0,0 +1,323 @@
+#include <gtest/gtest.h>
+
+#include "eminem/Writer.hpp"
+#include "eminem/to_text.hpp"
+#include "eminem/from_text.hpp"
+
+#include "temp_file_path.h"
+#include "simulate.h"
+
+#include <string>
+#include <vector>
+#include <complex>
+#include <fstream>
+#include <sstream>
+#include <random>
+#include <limits>
+#include <cmath>
+
+static std::string as_string(const std::vector<unsigned char>& contents) {
+    return std::string(contents.begin(), contents.end());
+}
+
+static auto reparse(const std::vector<unsigned char>& contents) {
+    return eminem::parse_text_buffer(contents.data(), contents.size(), {});
+}
+
+class WriterTest : public ::testing::TestWithParam<std::tuple<int, int> > {
+protected:
+    eminem::WriterOptions options() const {
+        auto param = GetParam();
+        eminem::WriterOptions opt;
+        opt.num_threads = std::get<0>(param);
+        opt.chunk_lines = std::get<1>(param);
+        return opt;
+    }
+};
+
+TEST_P(WriterTest, CoordinateInteger) {
+    std::size_t NR = 192, NC = 132;
+    auto coords = simulate_coordinate(NR, NC, 0.1);
+    auto values = simulate_integer(coords.first.size(), -999, 999);
+
+    std::vector<unsigned long long> rows, cols;
+    for (auto r : coords.first) {
+        rows.push_back(r + 1);
+    }
+    for (auto c : coords.second) {
+        cols.push_back(c + 1);
+    }
+
+    auto writer = eminem::write_text_buffer(options());
+    writer.write_preamble({ eminem::Object::MATRIX, eminem::Format::COORDINATE, eminem::Field::INTEGER, eminem::Symmetry::GENERAL }, NR, NC, values.size());
+
+    // Writing in two batches.
+    const std::size_t half = values.size() / 2;
+    writer.write_coordinate(half, rows.data(), cols.data(), values.data());
+    writer.write_coordinate(values.size() - half, rows.data() + half, cols.data() + half, values.data() + half);
+    writer.finish();
+
+    const auto& contents = writer.get_sink()->get_contents();
+    EXPECT_EQ(as_string(contents).rfind("%%MatrixMarket matrix coordinate integer general\n192 132 " + std::to_string(values.size()) + "\n", 0), 0);
+
+    auto parser = reparse(contents);
+    parser.scan_preamble();
+    EXPECT_EQ(parser.get_nrows(), NR);
+    EXPECT_EQ(parser.get_ncols(), NC);
+    EXPECT_EQ(parser.get_nlines(), values.size());
+
+    std::vector<unsigned long long> out_rows, out_cols;
+    std::vector<int> out_vals;
+    parser.scan_integer([&](unsigned long long r, unsigned long long c, int v) -> void {
+        out_rows.push_back(r);
+        out_cols.push_back(c);
+        out_vals.push_back(v);
+    });
+    EXPECT_EQ(out_rows, rows);
+    EXPECT_EQ(out_cols, cols);
+    EXPECT_EQ(out_vals, values);
+}
+
+TEST_P(WriterTest, CoordinateReal) {
+    std::size_t NR = 50, NC = 80;
+    auto coords = simulate_coordinate(NR, NC, 0.2);
+    auto values = simulate_real(coords.first.size());
+
+    // Adding some awkward values to check that they round-trip exactly.
+    values[0] = std::numeric_limits<double>::max();
+    values[1] = std::numeric_limits<double>::min();
+    values[2] = -0.1;
+    values[3] = 1e22;
+    values[4] = std::numeric_limits<double>::infinity();
+    values[5] = 0;
+
+    std::vector<unsigned long long> rows, cols;
+    for (auto r : coords.first) {
+        rows.push_back(r + 1);
+    }
+    for (auto c : coords.second) {
+        cols.push_back(c + 1);
+    }
+
+    auto writer = eminem::write_text_buffer(options());
+    writer.write_preamble({ eminem::Object::MATRIX, eminem::Format::COORDINATE, eminem::Field::REAL, eminem::Symmetry::GENERAL }, NR, NC, values.size());
+    writer.write_coordinate(values.size(), rows.data(), cols.data(), values.data());
+    writer.finish();
+
+    auto parser = reparse(writer.get_sink()->get_contents());
+    parser.scan_preamble();
+    std::vector<double> out_vals;
+    parser.scan_real([&](unsigned long long, unsigned long long, double v) -> void {
+        out_vals.push_back(v);
+    });
+    EXPECT_EQ(out_vals, values);
+}
+
+TEST_P(WriterTest, CoordinateComplex) {
+    std::size_t N = 1000;
+    auto coords = simulate_coordinate(N, 0.2);
+    auto values = simulate_complex(coords.size());
+
+    std::vector<unsigned long long> rows;
+    for (auto r : coords) {
+        rows.push_back(r + 1);
+    }
+
+    auto writer = eminem::write_text_buffer(options());
+    writer.write_preamble({ eminem::Object::VECTOR, eminem::Format::COORDINATE, eminem::Field::COMPLEX, eminem::Symmetry::GENERAL }, N, 1, values.size());
+    writer.write_coordinate(values.size(), rows.data(), static_cast<const unsigned long long*>(NULL), values.data());
+    writer.finish();
+
+    const auto& contents = writer.get_sink()->get_contents();
+    EXPECT_EQ(as_string(contents).rfind("%%MatrixMarket vector coordinate complex general\n1000 " + std::to_string(values.size()) + "\n", 0), 0);
+
+    auto parser = reparse(contents);
+    parser.scan_preamble();
+    std::vector<unsigned long long> out_rows;
+    std::vector<std::complex<double> > out_vals;
+    parser.scan_complex([&](unsigned long long r, unsigned long long c, std::complex<double> v) -> void {
+        out_rows.push_back(r);
+        EXPECT_EQ(c, 1);
+        out_vals.push_back(v);
+    });
+    EXPECT_EQ(out_rows, rows);
+    EXPECT_EQ(out_vals, values);
+}
+
+TEST_P(WriterTest, CoordinatePattern) {
+    std::size_t NR = 100, NC = 150;
+    auto coords = simulate_coordinate(NR, NC, 0.1);
+
+    std::vector<unsigned long long> rows, cols;
+    for (auto r : coords.first) {
+        rows.push_back(r + 1);
+    }
+    for (auto c : coords.second) {
+        cols.push_back(c + 1);
+    }
+
+    auto writer = eminem::write_text_buffer(options());
+    writer.write_preamble({ eminem::Object::MATRIX, eminem::Format::COORDINATE, eminem::Field::PATTERN, eminem::Symmetry::SYMMETRIC }, NR, NC, rows.size());
+    writer.write_coordinate_pattern(rows.size(), rows.data(), cols.data());
+    writer.finish();
+
+    auto parser = reparse(writer.get_sink()->get_contents());
+    parser.scan_preamble();
+    EXPECT_EQ(parser.get_banner().symmetry, eminem::Symmetry::SYMMETRIC);
+    std::vector<unsigned long long> out_rows, out_cols;
+    parser.scan_pattern([&](unsigned long long r, unsigned long long c, bool) -> void {
+        out_rows.push_back(r);
+        out_cols.push_back(c);
+    });
+    EXPECT_EQ(out_rows, rows);
+    EXPECT_EQ(out_cols, cols);
+}
+
+TEST_P(WriterTest, ArrayFloat) {
+    std::size_t NR = 31, NC = 47;
+    auto original = simulate_real(NR * NC);
+    std::vector<float> values(original.begin(), original.end());
+
+    auto writer = eminem::write_text_buffer(options());
+    writer.write_preamble({ eminem::Object::MATRIX, eminem::Format::ARRAY, eminem::Field::DOUBLE, eminem::Symmetry::GENERAL }, NR, NC, 0);
+    writer.write_array(values.size(), values.data());
+    writer.finish();
+
+    const auto& contents = writer.get_sink()->get_contents();
+    EXPECT_EQ(as_string(contents).rfind("%%MatrixMarket matrix array double general\n31 47\n", 0), 0);
+
+    auto parser = reparse(contents);
+    parser.scan_preamble();
+    std::vector<float> out_vals;
+    parser.template scan_double<float>([&](unsigned long long, unsigned long long, float v) -> void {
+        out_vals.push_back(v);
+    });
+    EXPECT_EQ(out_vals, values);
+}
+
+TEST_P(WriterTest, ArrayVectorHalfFloat) {
+    std::size_t N = 500;
+    auto original = simulate_real(N);
+    std::vector<eminem::Float16> values;
+    for (auto x : original) {
+        values.emplace_back(static_cast<float>(x));
+    }
+
+    auto writer = eminem::write_text_buffer(options());
+    writer.write_preamble({ eminem::Object::VECTOR, eminem::Format::ARRAY, eminem::Field::REAL, eminem::Symmetry::GENERAL }, N, 0, 0);
+    writer.write_array(values.size(), values.data());
+    writer.finish();
+
+    const auto& contents = writer.get_sink()->get_contents();
+    EXPECT_EQ(as_string(contents).rfind("%%MatrixMarket vector array real general\n500\n", 0), 0);
+
+    auto parser = reparse(contents);
+    parser.scan_preamble();
+    std::vector<std::uint16_t> out_bits;
+    parser.template scan_real<eminem::Float16>([&](unsigned long long, unsigned long long, eminem::Float16 v) -> void {
+        out_bits.push_back(v.bits);
+    });
+    ASSERT_EQ(out_bits.size(), values.size());
+    for (std::size_t i = 0; i < N; ++i) {
+        EXPECT_EQ(out_bits[i], values[i].bits);
+    }
+}
+
+TEST_P(WriterTest, OutOfRange) {
+    std::vector<unsigned long long> rows(100, 1), cols(100, 1);
+    std::vector<int> values(100);
+    rows[77] = 11;
+
+    auto writer = eminem::write_text_buffer(options());
+    writer.write_preamble({ eminem::Object::MATRIX, eminem::Format::COORDINATE, eminem::Field::INTEGER, eminem::Symmetry::GENERAL }, 10, 10, 100);
+    try {
+        writer.write_coordinate(values.size(), rows.data(), cols.data(), values.data());
+        FAIL() << "expected an error";
+    } catch (std::exception& e) {
+        EXPECT_EQ(std::string(e.what()), "row index out of range for data line 78");
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(
+    Writer,
+    WriterTest,
+    ::testing::Combine(
+        ::testing::Values(1, 2, 3), // number of threads
+        ::testing::Values(1, 7, 100000) // number of lines per chunk
+    )
+);
+
+TEST(Writer, File) {
+    auto path = temp_file_path("writer");
+    std::vector<unsigned long long> rows { 1, 3, 2 }, cols { 2, 1, 3 };
+    std::vector<double> values { 0.5, -1, 1e-300 };
+
+    {
+        auto writer = eminem::write_text_file(path.c_str(), {});
+        writer.write_preamble({ eminem::Object::MATRIX, eminem::Format::COORDINATE, eminem::Field::REAL, eminem::Symmetry::GENERAL }, 3, 3, 3);
+        writer.write_coordinate(3, rows.data(), cols.data(), values.data());
+        writer.finish();
+    }
+
+    std::ifstream handle(path);
+    std::stringstream buffer;
+    buffer << handle.rdbuf();
+    EXPECT_EQ(buffer.str(), "%%MatrixMarket matrix coordinate real general\n3 3 3\n1 2 0.5\n3 1 -1\n2 3 1e-300\n");
+}
+
+template<class Function_>
+static void expect_error(Function_ fun, std::string msg) {
+    try {
+        fun();
+        FAIL() << "expected an error";
+    } catch (std::exception& e) {
+        EXPECT_TRUE(std::string(e.what()).find(msg) != std::string::npos) << e.what();
+    }
+}
+
+TEST(Writer, Errors) {
+    std::vector<unsigned long long> rows { 1, 2 }, cols { 1, 2 };
+    std::vector<int> ivalues { 1, 2 };
+    std::vector<double> dvalues { 1, 2 };
+
+    expect_error([&]() -> void {
+        auto writer = eminem::write_text_buffer({});
+        writer.write_coordinate(2, rows.data(), cols.data(), ivalues.data());
+    }, "preamble has not yet been written");
+
+    expect_error([&]() -> void {
+        auto writer = eminem::write_text_buffer({});
+        writer.write_preamble({ eminem::Object::MATRIX, eminem::Format::COORDINATE, eminem::Field::REAL, eminem::Symmetry::HERMITIAN }, 2, 2, 2);
+    }, "'hermitian' symmetry");
+
+    expect_error([&]() -> void {
+        auto writer = eminem::write_text_buffer({});
+        writer.write_preamble({ eminem::Object::MATRIX, eminem::Format::COORDINATE, eminem::Field::INTEGER, eminem::Symmetry::GENERAL }, 2, 2, 2);
+        writer.write_coordinate(2, rows.data(), cols.data(), dvalues.data());
+    }, "floating-point values can only be written");
+
+    expect_error([&]() -> void {
+        auto writer = eminem::write_text_buffer({});
+        writer.write_preamble({ eminem::Object::MATRIX, eminem::Format::COORDINATE, eminem::Field::INTEGER, eminem::Symmetry::GENERAL }, 2, 2, 2);
+        writer.write_array(2, ivalues.data());
+    }, "'array' format");
+
+    expect_error([&]() -> void {
+        auto writer = eminem::write_text_buffer({});
+        writer.write_preamble({ eminem::Object::MATRIX, eminem::Format::COORDINATE, eminem::Field::INTEGER, eminem::Symmetry::GENERAL }, 2, 2, 1);
+        writer.write_coordinate(2, rows.data(), cols.data(), ivalues.data());
+    }, "exceeds that specified in the size line");
+
+    expect_error([&]() -> void {
+        auto writer = eminem::write_text_buffer({});
+        writer.write_preamble({ eminem::Object::MATRIX, eminem::Format::COORDINATE, eminem::Field::INTEGER, eminem::Symmetry::GENERAL }, 2, 2, 3);
+        writer.write_coordinate(2, rows.data(), cols.data(), ivalues.data());
+        writer.finish();
+    }, "expected 3 data lines but only 2");
+
+    expect_error([&]() -> void {
+        auto writer = eminem::write_text_buffer({});
+        writer.write_preamble({ eminem::Object::MATRIX, eminem::Format::COORDINATE, eminem::Field::INTEGER, eminem::Symmetry::GENERAL }, 2, 2, 2);
+        writer.write_coordinate_pattern(2, rows.data(), cols.data());
+    }, "'pattern' field");
+}